@@ -0,0 +1,102 @@
+#include <functional>
+#include <random>
+#include <variant>
+#include <vector>
+
+#include <mamePID/any.hpp>
+
+#include "architectures.hpp"
+#include "benchmark.hpp"
+
+// Heterogeneous populations of n controllers, PID, PI-D and I-PD in random order, stepped once per
+// iteration through each kind of type erasure.
+
+namespace {
+
+template<typename T>
+using Variant = std::variant<
+  decltype(bench::Pid::make<T>()),
+  decltype(bench::PiD::make<T>()),
+  decltype(bench::IPd::make<T>())>;
+
+template<typename T>
+std::vector<Variant<T>>
+population(std::size_t n)
+{
+  std::mt19937                       rng(1);
+  std::uniform_int_distribution<int> kind(0, 2);
+  std::vector<Variant<T>>            controllers;
+  controllers.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    switch (kind(rng)) {
+      case 0:
+        controllers.emplace_back(bench::Pid::make<T>());
+        break;
+      case 1:
+        controllers.emplace_back(bench::PiD::make<T>());
+        break;
+      default:
+        controllers.emplace_back(bench::IPd::make<T>());
+        break;
+    }
+  }
+  return controllers;
+}
+
+template<typename T, typename Controllers, typename Step>
+void
+run(bench::State& state, Controllers& controllers, Step step)
+{
+  const std::size_t n = controllers.size();
+  std::vector<T>    pvs(n, T(0));
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) {
+      pvs[i] = step(controllers[i], pvs[i]);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+} // namespace
+
+template<typename T>
+void
+BM_any_controller(bench::State& state)
+{
+  std::vector<mamePID::AnyController<T>> controllers;
+  for (auto& controller : population<T>(state.range(0))) {
+    std::visit([&](auto& c) { controllers.emplace_back(c); }, controller);
+  }
+  run<T>(state, controllers, [](auto& c, T pv) { return c.calculate(T(1), pv); });
+}
+
+template<typename T>
+void
+BM_std_function(bench::State& state)
+{
+  std::vector<std::function<T(T, T)>> controllers;
+  for (auto& controller : population<T>(state.range(0))) {
+    std::visit(
+      [&](auto& c) {
+        controllers.emplace_back([c](T setpoint, T pv) mutable { return c.calculate(setpoint, pv); });
+      },
+      controller
+    );
+  }
+  run<T>(state, controllers, [](auto& c, T pv) { return c(T(1), pv); });
+}
+
+template<typename T>
+void
+BM_std_variant(bench::State& state)
+{
+  auto controllers = population<T>(state.range(0));
+  run<T>(state, controllers, [](auto& c, T pv) {
+    return std::visit([pv](auto& controller) { return controller.calculate(T(1), pv); }, c);
+  });
+}
+
+BENCHMARK_TEMPLATE(BM_any_controller, double)->Range(1 << 6, 1 << 16);
+BENCHMARK_TEMPLATE(BM_std_function, double)->Range(1 << 6, 1 << 16);
+BENCHMARK_TEMPLATE(BM_std_variant, double)->Range(1 << 6, 1 << 16);
@@ -0,0 +1,120 @@
+#ifndef MAMEPID_BENCH_ARCHITECTURES_HPP_
+#define MAMEPID_BENCH_ARCHITECTURES_HPP_
+
+#include <cstddef>
+
+#include <mamePID.hpp>
+#include <mamePID/bank.hpp>
+
+namespace bench {
+
+struct Pid
+{
+  template<typename T>
+  static auto make()
+  {
+    return mamePID::pid<T>(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  }
+
+  template<typename T>
+  static auto bank(std::size_t n)
+  {
+    auto bank = mamePID::pid_bank<T>(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      bank.push_back({ 0.8, 2.3, 0.05 }, 0.01, -10.0, 10.0);
+    }
+    return bank;
+  }
+};
+
+struct PiD
+{
+  template<typename T>
+  static auto make()
+  {
+    return mamePID::pi_d<T>(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  }
+
+  template<typename T>
+  static auto bank(std::size_t n)
+  {
+    auto bank = mamePID::pi_d_bank<T>(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      bank.push_back({ 0.8, 2.3, 0.05 }, 0.01, -10.0, 10.0);
+    }
+    return bank;
+  }
+};
+
+struct IPd
+{
+  template<typename T>
+  static auto make()
+  {
+    return mamePID::i_pd<T>(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  }
+
+  template<typename T>
+  static auto bank(std::size_t n)
+  {
+    auto bank = mamePID::i_pd_bank<T>(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      bank.push_back({ 0.8, 2.3, 0.05 }, 0.01, -10.0, 10.0);
+    }
+    return bank;
+  }
+};
+
+// Cycles through the PID, PI-D and I-PD weights, so a bank mixes all three architectures.
+struct Pid2Dof
+{
+  template<typename T>
+  static auto make()
+  {
+    return mamePID::pid_2dof<T>(0.8, 2.3, 0.05, 1.0, 0.0, 0.01, -10.0, 10.0);
+  }
+
+  template<typename T>
+  static auto bank(std::size_t n)
+  {
+    const mamePID::Weights<T> weights[] = { { 1, 1 }, { 1, 0 }, { 0, 0 } };
+
+    auto bank = mamePID::pid_2dof_bank<T>(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      bank.push_back({ 0.8, 2.3, 0.05 }, weights[i % 3], 0.01, -10.0, 10.0);
+    }
+    return bank;
+  }
+};
+
+struct VelocityPid
+{
+  template<typename T>
+  static auto make()
+  {
+    return mamePID::velocity_pid<T>(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  }
+};
+
+struct PidFiltered
+{
+  template<typename T>
+  static auto make()
+  {
+    return mamePID::pid_filtered<T>(0.8, 2.3, 0.05, 10.0, 0.01, -10.0, 10.0);
+  }
+};
+
+template<template<typename> typename IntegralT>
+struct PidAntiWindup
+{
+  template<typename T>
+  static auto make()
+  {
+    return mamePID::pid<IntegralT, T>(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  }
+};
+
+} // namespace bench
+
+#endif // MAMEPID_BENCH_ARCHITECTURES_HPP_
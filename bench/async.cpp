@@ -0,0 +1,108 @@
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include <mamePID/async.hpp>
+
+#include "architectures.hpp"
+#include "benchmark.hpp"
+
+// One step of range(0) loops, each waiting for a sensor value, stepping its controller and handing the
+// output to the IO side, which replies with the next sensor value. The throughput counts loop steps.
+
+namespace {
+
+template<typename T>
+T
+plant(T y, T u)
+{
+  return y + T(0.1) * (u - y);
+}
+
+} // namespace
+
+// Every loop is a coroutine on one Executor, suspended in Mailbox::read() between steps.
+template<typename T, typename Architecture>
+void
+BM_coroutine_loops(bench::State& state)
+{
+  const auto        n           = static_cast<std::size_t>(state.range(0));
+  auto              controllers = std::vector(n, Architecture::template make<T>());
+  const T           setpoint    = T(1);
+  mamePID::Executor executor;
+
+  std::vector<std::unique_ptr<mamePID::Mailbox<T>>> sensors, actuators;
+  for (std::size_t i = 0; i < n; ++i) {
+    sensors.push_back(std::make_unique<mamePID::Mailbox<T>>(executor));
+    actuators.push_back(std::make_unique<mamePID::Mailbox<T>>(executor));
+    executor.spawn(mamePID::drive(controllers[i], *sensors[i], *actuators[i], setpoint));
+  }
+  executor.run();
+
+  std::vector<T> y(n, T(0));
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) {
+      sensors[i]->push(y[i]);
+    }
+    executor.run();
+    for (std::size_t i = 0; i < n; ++i) {
+      y[i] = plant(y[i], *actuators[i]->try_read());
+    }
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+// Every loop is a thread, blocked on a semaphore between steps.
+template<typename T, typename Architecture>
+void
+BM_thread_loops(bench::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  struct Loop
+  {
+    std::binary_semaphore request{ 0 };
+    std::binary_semaphore response{ 0 };
+    T                     pv   = T(0);
+    T                     u    = T(0);
+    bool                  stop = false;
+  };
+  std::vector<std::unique_ptr<Loop>> loops;
+  std::vector<std::thread>           threads;
+  for (std::size_t i = 0; i < n; ++i) {
+    loops.push_back(std::make_unique<Loop>());
+    threads.emplace_back([&loop = *loops.back()] {
+      auto controller = Architecture::template make<T>();
+      for (;;) {
+        loop.request.acquire();
+        if (loop.stop) {
+          return;
+        }
+        loop.u = controller.calculate(T(1), loop.pv);
+        loop.response.release();
+      }
+    });
+  }
+
+  std::vector<T> y(n, T(0));
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) {
+      loops[i]->pv = y[i];
+      loops[i]->request.release();
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      loops[i]->response.acquire();
+      y[i] = plant(y[i], loops[i]->u);
+    }
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    loops[i]->stop = true;
+    loops[i]->request.release();
+    threads[i].join();
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_coroutine_loops, double, bench::Pid)->Range(1 << 4, 1 << 12);
+BENCHMARK_TEMPLATE(BM_thread_loops, double, bench::Pid)->Range(1 << 4, 1 << 8);
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <mamePID/bank.hpp>
+#include <mamePID/fixed.hpp>
+
+#include "architectures.hpp"
+#include "benchmark.hpp"
+
+namespace {
+
+constexpr std::int64_t max_loops = 1 << 20;
+
+template<typename T>
+std::vector<T>
+random_signal(std::size_t n, unsigned seed)
+{
+  std::mt19937                      rng(seed);
+  std::uniform_real_distribution<T> signal(-1.0, 1.0);
+  std::vector<T>                    values(n);
+  std::generate(values.begin(), values.end(), [&] { return signal(rng); });
+  return values;
+}
+
+} // namespace
+
+// Throughput of one PIDBank step over n loops.
+template<typename T, typename Architecture>
+void
+BM_bank(bench::State& state)
+{
+  const auto n         = static_cast<std::size_t>(state.range(0));
+  auto       bank      = Architecture::template bank<T>(n);
+  const auto setpoints = random_signal<T>(n, 1);
+  const auto pvs       = random_signal<T>(n, 2);
+  auto       out       = std::vector<T>(n);
+  for ([[maybe_unused]] auto _ : state) {
+    bank.calculate(setpoints, pvs, out);
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+// The same population as individual PID objects, stepped in storage order.
+template<typename T, typename Architecture>
+void
+BM_objects(bench::State& state)
+{
+  const auto n           = static_cast<std::size_t>(state.range(0));
+  auto       controllers = std::vector(n, Architecture::template make<T>());
+  const auto setpoints   = random_signal<T>(n, 1);
+  const auto pvs         = random_signal<T>(n, 2);
+  auto       out         = std::vector<T>(n);
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = controllers[i].calculate(setpoints[i], pvs[i]);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+// Individual PID objects stepped in a random order, which defeats the prefetcher once the population
+// no longer fits in cache.
+template<typename T, typename Architecture>
+void
+BM_objects_random(bench::State& state)
+{
+  const auto n           = static_cast<std::size_t>(state.range(0));
+  auto       controllers = std::vector(n, Architecture::template make<T>());
+  const auto setpoints   = random_signal<T>(n, 1);
+  const auto pvs         = random_signal<T>(n, 2);
+  auto       out         = std::vector<T>(n);
+  auto       order       = std::vector<std::size_t>(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(3));
+  for ([[maybe_unused]] auto _ : state) {
+    for (auto i : order) {
+      out[i] = controllers[i].calculate(setpoints[i], pvs[i]);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+// One step of a Q15 PI bank through the scalar Fixed operators or the 16-bit lane kernel.
+template<bool Vector>
+void
+BM_fixed_bank(bench::State& state)
+{
+  using Q15            = mamePID::Fixed<std::int16_t, 15>;
+  const auto n         = static_cast<std::size_t>(state.range(0));
+  auto       bank      = mamePID::pi_bank<Q15>(n);
+  const auto signal    = random_signal<double>(2 * n, 1);
+  auto       setpoints = std::vector<Q15>(n);
+  auto       pvs       = std::vector<Q15>(n);
+  auto       out       = std::vector<Q15>(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    bank.push_back({ Q15(0.5), Q15(0.25), Q15(0) }, Q15(0.01), Q15(-0.9), Q15(0.9));
+    setpoints[i] = Q15(0.9 * signal[i]);
+    pvs[i]       = Q15(0.9 * signal[n + i]);
+  }
+  const auto isa = Vector ? mamePID::simd::best() : mamePID::simd::Isa::Scalar;
+  for ([[maybe_unused]] auto _ : state) {
+    bank.calculate(setpoints, pvs, out, isa);
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_bank, float, bench::Pid)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_bank, float, bench::PiD)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_bank, float, bench::IPd)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_bank, double, bench::Pid)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_bank, double, bench::PiD)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_bank, double, bench::IPd)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_bank, double, bench::Pid2Dof)->Range(1, max_loops);
+
+BENCHMARK_TEMPLATE(BM_fixed_bank, false)->Range(1 << 6, max_loops);
+BENCHMARK_TEMPLATE(BM_fixed_bank, true)->Range(1 << 6, max_loops);
+
+BENCHMARK_TEMPLATE(BM_objects, float, bench::Pid)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_objects, double, bench::Pid)->Range(1, max_loops);
+
+BENCHMARK_TEMPLATE(BM_objects_random, float, bench::Pid)->Range(1, max_loops);
+BENCHMARK_TEMPLATE(BM_objects_random, double, bench::Pid)->Range(1, max_loops);
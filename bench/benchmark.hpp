@@ -0,0 +1,184 @@
+#ifndef MAMEPID_BENCH_BENCHMARK_HPP_
+#define MAMEPID_BENCH_BENCHMARK_HPP_
+
+// A small, dependency-free subset of the Google Benchmark API. Results can be written in the same JSON
+// layout as Google Benchmark, so its compare.py works on them.
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+template<typename T>
+inline void
+DoNotOptimize(T& value)
+{
+  asm volatile("" : "+m"(value) : : "memory");
+}
+
+template<typename T>
+inline void
+DoNotOptimize(const T& value)
+{
+  asm volatile("" : : "m"(value) : "memory");
+}
+
+inline void
+ClobberMemory()
+{
+  asm volatile("" : : : "memory");
+}
+
+class State
+{
+public:
+  State(std::int64_t iterations, std::vector<std::int64_t> args)
+    : iterations(iterations)
+    , args(std::move(args))
+  {
+  }
+
+  class Iterator
+  {
+  public:
+    Iterator(State* state, std::int64_t remaining)
+      : state(state)
+      , remaining(remaining)
+    {
+    }
+
+    int  operator*() const { return 0; }
+    void operator++() { --remaining; }
+
+    bool operator!=(const Iterator&)
+    {
+      if (0 < remaining) {
+        return true;
+      }
+      state->stop();
+      return false;
+    }
+
+  private:
+    State*       state;
+    std::int64_t remaining;
+  };
+
+  Iterator begin()
+  {
+    start();
+    return Iterator(this, iterations);
+  }
+
+  Iterator end() { return Iterator(this, 0); }
+
+  std::int64_t range(std::size_t i = 0) const { return args.at(i); }
+  std::int64_t max_iterations() const { return iterations; }
+
+  void SetItemsProcessed(std::int64_t items) { items_processed = items; }
+  void SetBytesProcessed(std::int64_t bytes) { bytes_processed = bytes; }
+  void SetLabel(std::string text) { label = std::move(text); }
+
+  void PauseTiming() { stop(); }
+  void ResumeTiming()
+  {
+    started     = std::chrono::steady_clock::now();
+    cpu_started = std::clock();
+  }
+
+  double       seconds() const { return std::chrono::duration<double>(elapsed).count(); }
+  double       cpu_seconds() const { return static_cast<double>(cpu_elapsed) / CLOCKS_PER_SEC; }
+  std::int64_t items() const { return items_processed; }
+  std::int64_t bytes() const { return bytes_processed; }
+
+  const std::string& get_label() const { return label; }
+
+private:
+  void start()
+  {
+    elapsed     = {};
+    cpu_elapsed = 0;
+    ResumeTiming();
+  }
+
+  void stop()
+  {
+    elapsed     += std::chrono::steady_clock::now() - started;
+    cpu_elapsed += std::clock() - cpu_started;
+  }
+
+  std::int64_t                          iterations;
+  std::vector<std::int64_t>             args;
+  std::int64_t                          items_processed = 0;
+  std::int64_t                          bytes_processed = 0;
+  std::string                           label;
+  std::chrono::steady_clock::time_point started;
+  std::chrono::steady_clock::duration   elapsed{};
+  std::clock_t                          cpu_started = 0;
+  std::clock_t                          cpu_elapsed = 0;
+};
+
+class Benchmark
+{
+public:
+  Benchmark(std::string name, std::function<void(State&)> function)
+    : name(std::move(name))
+    , function(std::move(function))
+  {
+  }
+
+  Benchmark* Arg(std::int64_t arg)
+  {
+    args.push_back({ arg });
+    return this;
+  }
+
+  Benchmark* RangeMultiplier(std::int64_t multiplier)
+  {
+    range_multiplier = multiplier;
+    return this;
+  }
+
+  // Powers of the range multiplier between lo and hi, with both ends included.
+  Benchmark* Range(std::int64_t lo, std::int64_t hi)
+  {
+    for (std::int64_t arg = lo; arg < hi; arg *= range_multiplier) {
+      Arg(arg);
+    }
+    return Arg(hi);
+  }
+
+  const std::string&                            get_name() const { return name; }
+  const std::vector<std::vector<std::int64_t>>& get_args() const { return args; }
+
+  void run(State& state) const { function(state); }
+
+private:
+  std::string                            name;
+  std::function<void(State&)>            function;
+  std::vector<std::vector<std::int64_t>> args;
+  std::int64_t                           range_multiplier = 8;
+};
+
+std::vector<Benchmark*>& registry();
+
+Benchmark* RegisterBenchmark(std::string name, std::function<void(State&)> function);
+
+} // namespace bench
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b)  BENCHMARK_CONCAT_(a, b)
+
+#define BENCHMARK(...)                                                                                       \
+  [[maybe_unused]] static ::bench::Benchmark* BENCHMARK_CONCAT(benchmark_registration_, __COUNTER__) =       \
+    ::bench::RegisterBenchmark(#__VA_ARGS__, __VA_ARGS__)
+
+#define BENCHMARK_TEMPLATE(fn, ...)                                                                          \
+  [[maybe_unused]] static ::bench::Benchmark* BENCHMARK_CONCAT(benchmark_registration_, __COUNTER__) =       \
+    ::bench::RegisterBenchmark(#fn "<" #__VA_ARGS__ ">", fn<__VA_ARGS__>)
+
+#endif // MAMEPID_BENCH_BENCHMARK_HPP_
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <mamePID/cascade.hpp>
+
+#include "benchmark.hpp"
+
+// A position loop driving a velocity loop, with the inner loop running range(0) times as often as the
+// outer one.
+
+namespace {
+
+constexpr std::size_t samples = 1 << 12;
+
+template<typename T>
+auto
+outer_loop(std::uint32_t ratio)
+{
+  return mamePID::pid<T>(2.0, 0.5, 0.0, 0.001 * ratio, -5.0, 5.0);
+}
+
+template<typename T>
+auto
+inner_loop()
+{
+  return mamePID::pid<T>(0.8, 4.0, 0.01, 0.001, -1.0, 1.0);
+}
+
+template<typename T>
+std::vector<T>
+wave(std::size_t n, T frequency)
+{
+  std::vector<T> values(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    values[i] = std::sin(frequency * T(i));
+  }
+  return values;
+}
+
+} // namespace
+
+// Both loops stepped from user code, the outer output passed on as the inner setpoint.
+template<typename T>
+void
+BM_cascade_chained(bench::State& state)
+{
+  const auto ratio     = static_cast<std::uint32_t>(state.range(0));
+  auto       outer     = outer_loop<T>(ratio);
+  auto       inner     = inner_loop<T>();
+  const auto positions = wave<T>(samples, T(0.01));
+  const auto speeds    = wave<T>(samples, T(0.02));
+  auto       out       = std::vector<T>(samples);
+  for ([[maybe_unused]] auto _ : state) {
+    T inner_sp{};
+    for (std::size_t k = 0; k < samples; ++k) {
+      if (k % ratio == 0) {
+        inner_sp = outer.calculate(T(1), positions[k]);
+      }
+      out[k] = inner.calculate(inner_sp, speeds[k]);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * samples);
+}
+
+template<typename T>
+void
+BM_cascade_calculate(bench::State& state)
+{
+  const auto ratio     = static_cast<std::uint32_t>(state.range(0));
+  auto       cascade   = mamePID::cascade(outer_loop<T>(ratio), inner_loop<T>(), ratio);
+  const auto positions = wave<T>(samples, T(0.01));
+  const auto speeds    = wave<T>(samples, T(0.02));
+  auto       out       = std::vector<T>(samples);
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::size_t k = 0; k < samples; ++k) {
+      out[k] = cascade.calculate(T(1), positions[k], speeds[k]);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * samples);
+}
+
+template<typename T>
+void
+BM_cascade_run(bench::State& state)
+{
+  const auto ratio     = static_cast<std::uint32_t>(state.range(0));
+  auto       cascade   = mamePID::cascade(outer_loop<T>(ratio), inner_loop<T>(), ratio);
+  const auto setpoints = std::vector<T>(samples, T(1));
+  const auto positions = wave<T>(samples, T(0.01));
+  const auto speeds    = wave<T>(samples, T(0.02));
+  auto       out       = std::vector<T>(samples);
+  for ([[maybe_unused]] auto _ : state) {
+    cascade.run(setpoints, positions, speeds, out);
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * samples);
+}
+
+// The block-fused alternative to Cascade::run: one outer update, then the inner loop over the ratio samples
+// up to the next one without a phase branch.
+template<typename T>
+void
+BM_cascade_fused(bench::State& state)
+{
+  const auto ratio     = static_cast<std::uint32_t>(state.range(0));
+  const auto setpoints = std::vector<T>(samples, T(1));
+  const auto positions = wave<T>(samples, T(0.01));
+  const auto speeds    = wave<T>(samples, T(0.02));
+  auto       out       = std::vector<T>(samples);
+  auto       outer     = outer_loop<T>(ratio);
+  auto       inner     = inner_loop<T>();
+  for ([[maybe_unused]] auto _ : state) {
+    auto o = outer;
+    auto i = inner;
+    for (std::size_t k = 0; k < samples; k += ratio) {
+      const T           inner_sp = o.calculate(setpoints[k], positions[k]);
+      const std::size_t end      = std::min<std::size_t>(k + ratio, samples);
+      for (std::size_t j = k; j < end; ++j) {
+        out[j] = i.calculate(inner_sp, speeds[j]);
+      }
+    }
+    outer = o;
+    inner = i;
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * samples);
+}
+
+// One tick of range(0) axes with an outer update every fourth tick.
+template<typename T>
+void
+BM_cascade_bank(bench::State& state)
+{
+  const auto n    = static_cast<std::size_t>(state.range(0));
+  auto       bank = mamePID::cascade_bank(mamePID::pid_bank<T>(n), mamePID::pid_bank<T>(n), 4);
+  for (std::size_t i = 0; i < n; ++i) {
+    bank.outer().push_back({ 2.0, 0.5, 0.0 }, 0.004, -5.0, 5.0);
+    bank.inner().push_back({ 0.8, 4.0, 0.01 }, 0.001, -1.0, 1.0);
+  }
+  const auto setpoints = std::vector<T>(n, T(1));
+  const auto positions = wave<T>(n, T(0.01));
+  const auto speeds    = wave<T>(n, T(0.02));
+  auto       out       = std::vector<T>(n);
+  for ([[maybe_unused]] auto _ : state) {
+    bank.calculate(setpoints, positions, speeds, out);
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_cascade_chained, double)->Arg(1)->Arg(4)->Arg(10);
+BENCHMARK_TEMPLATE(BM_cascade_calculate, double)->Arg(1)->Arg(4)->Arg(10);
+BENCHMARK_TEMPLATE(BM_cascade_run, double)->Arg(1)->Arg(4)->Arg(10);
+BENCHMARK_TEMPLATE(BM_cascade_fused, double)->Arg(1)->Arg(4)->Arg(10);
+BENCHMARK_TEMPLATE(BM_cascade_bank, double)->Range(1 << 6, 1 << 16);
@@ -0,0 +1,112 @@
+#include <memory>
+#include <vector>
+
+#include <mamePID/telemetry.hpp>
+
+#include "architectures.hpp"
+#include "benchmark.hpp"
+
+// Latency of a single calculate() call. Each update feeds the previous output back as the process
+// value, so consecutive calls form a dependency chain and cannot overlap.
+template<typename T, typename Architecture>
+void
+BM_calculate(bench::State& state)
+{
+  auto controller = Architecture::template make<T>();
+  T    pv         = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    pv = controller.calculate(T(1), pv);
+  }
+  bench::DoNotOptimize(pv);
+  state.SetItemsProcessed(state.max_iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_calculate, float, bench::Pid);
+BENCHMARK_TEMPLATE(BM_calculate, float, bench::PiD);
+BENCHMARK_TEMPLATE(BM_calculate, float, bench::IPd);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::Pid);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::PiD);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::IPd);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::VelocityPid);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::PidFiltered);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::PidAntiWindup<mamePID::BackCalculationIntegral>);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::PidAntiWindup<mamePID::ConditionalIntegral>);
+BENCHMARK_TEMPLATE(BM_calculate, double, bench::PidAntiWindup<mamePID::FreezingIntegral>);
+
+// calculate(setpoint, pv, dt) with a period that alternates around the nominal one, to compare with the
+// fixed-period BM_calculate.
+template<typename T, typename Architecture>
+void
+BM_calculate_variable_dt(bench::State& state)
+{
+  auto controller = Architecture::template make<T>();
+  T    pv         = 0;
+  T    dt         = T(0.009);
+  for ([[maybe_unused]] auto _ : state) {
+    pv = controller.calculate(T(1), pv, dt);
+    dt = T(0.02) - dt;
+  }
+  bench::DoNotOptimize(pv);
+  state.SetItemsProcessed(state.max_iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_calculate_variable_dt, double, bench::Pid);
+BENCHMARK_TEMPLATE(BM_calculate_variable_dt, double, bench::IPd);
+
+// Replaying a recorded log of n samples, one calculate() call per sample.
+template<typename T, typename Architecture>
+void
+BM_replay_calculate(bench::State& state)
+{
+  const auto     n          = static_cast<std::size_t>(state.range(0));
+  auto           controller = Architecture::template make<T>();
+  std::vector<T> setpoints(n, T(1)), pvs(n, T(0.5)), out(n);
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::size_t k = 0; k < n; ++k) {
+      out[k] = controller.calculate(setpoints[k], pvs[k]);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+// The same replay through PID::run.
+template<typename T, typename Architecture>
+void
+BM_replay_run(bench::State& state)
+{
+  const auto     n          = static_cast<std::size_t>(state.range(0));
+  auto           controller = Architecture::template make<T>();
+  std::vector<T> setpoints(n, T(1)), pvs(n, T(0.5)), out(n);
+  for ([[maybe_unused]] auto _ : state) {
+    controller.run(setpoints, pvs, out);
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_replay_calculate, double, bench::Pid)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_replay_run, double, bench::Pid)->Range(1 << 10, 1 << 20);
+
+// calculate() through Traced. The ring is drained on the benchmark thread every 512 updates, so the
+// consumer's share is included in the reported time.
+template<typename T, typename Architecture>
+void
+BM_calculate_traced(bench::State& state)
+{
+  auto ring       = std::make_unique<mamePID::TelemetryRing<T, 1024>>();
+  auto controller = mamePID::traced(Architecture::template make<T>(), *ring);
+  T    pv         = 0;
+  int  n          = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    pv = controller.calculate(T(1), pv);
+    if (++n == 512) {
+      ring->drain([](const auto& sample) { bench::DoNotOptimize(sample); });
+      n = 0;
+    }
+  }
+  bench::DoNotOptimize(pv);
+  state.SetItemsProcessed(state.max_iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_calculate_traced, double, bench::Pid);
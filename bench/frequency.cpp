@@ -0,0 +1,59 @@
+#include <vector>
+
+#include <mamePID/frequency.hpp>
+
+#include "benchmark.hpp"
+
+// Gain and phase margins of range(0) PID loops around a first-order plus dead time model, on a grid of
+// 256 frequencies.
+
+namespace {
+
+constexpr std::size_t points = 256;
+
+template<typename T>
+std::vector<mamePID::Gains<T>>
+loops(std::size_t n)
+{
+  std::vector<mamePID::Gains<T>> gains(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    gains[i] = { T(0.1) + T(0.001) * T(i % 1000), T(0.5) + T(0.01) * T(i / 1000), T(0.001) * T(i % 7) };
+  }
+  return gains;
+}
+
+} // namespace
+
+// One controller at a time through its response().
+template<typename T>
+void
+BM_margins(bench::State& state)
+{
+  const auto gains = loops<T>(state.range(0));
+  const auto model = mamePID::first_order_dead_time(T(1.2), T(0.3), T(0.05), T(0.01));
+  const auto omega = mamePID::log_grid(T(0.01), T(300), points);
+  for ([[maybe_unused]] auto _ : state) {
+    for (const auto& g : gains) {
+      const auto m = mamePID::margins(mamePID::pid(g.kp, g.ki, g.kd, T(0.01)), model, std::span(omega));
+      bench::DoNotOptimize(m.gain);
+    }
+  }
+  state.SetItemsProcessed(state.max_iterations() * gains.size());
+}
+
+template<typename T>
+void
+BM_bank_margins(bench::State& state)
+{
+  const auto gains = loops<T>(state.range(0));
+  const auto model = mamePID::first_order_dead_time(T(1.2), T(0.3), T(0.05), T(0.01));
+  const auto omega = mamePID::log_grid(T(0.01), T(300), points);
+  for ([[maybe_unused]] auto _ : state) {
+    auto margins = mamePID::bank_margins(std::span(gains), model, std::span(omega));
+    bench::DoNotOptimize(margins.data());
+  }
+  state.SetItemsProcessed(state.max_iterations() * gains.size());
+}
+
+BENCHMARK_TEMPLATE(BM_margins, double)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_bank_margins, double)->Range(1 << 8, 1 << 14);
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <mamePID/simd.hpp>
+
+#include "benchmark.hpp"
+
+namespace bench {
+
+std::vector<Benchmark*>&
+registry()
+{
+  static std::vector<Benchmark*> benchmarks;
+  return benchmarks;
+}
+
+Benchmark*
+RegisterBenchmark(std::string name, std::function<void(State&)> function)
+{
+  registry().push_back(new Benchmark(std::move(name), std::move(function)));
+  return registry().back();
+}
+
+} // namespace bench
+
+namespace {
+
+struct Options
+{
+  std::string filter   = ".";
+  std::string out;
+  std::string format   = "console";
+  double      min_time = 0.1;
+};
+
+struct Result
+{
+  std::string  name;
+  std::int64_t iterations;
+  double       ns_per_iteration;
+  double       cpu_ns_per_iteration;
+  double       items_per_second;
+  double       bytes_per_second;
+  std::string  label;
+};
+
+const char*
+isa_name(mamePID::simd::Isa isa)
+{
+  switch (isa) {
+    case mamePID::simd::Isa::Scalar:
+      return "scalar";
+    case mamePID::simd::Isa::SSE2:
+      return "sse2";
+    case mamePID::simd::Isa::AVX2:
+      return "avx2";
+    case mamePID::simd::Isa::AVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+Options
+parse(int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    const auto             value = [&](std::string_view flag) { return std::string(arg.substr(flag.size())); };
+    if (arg.starts_with("--benchmark_filter=")) {
+      options.filter = value("--benchmark_filter=");
+    } else if (arg.starts_with("--benchmark_out=")) {
+      options.out = value("--benchmark_out=");
+    } else if (arg.starts_with("--benchmark_format=")) {
+      options.format = value("--benchmark_format=");
+    } else if (arg.starts_with("--benchmark_min_time=")) {
+      options.min_time = std::stod(value("--benchmark_min_time="));
+    } else {
+      std::cerr << "unknown option: " << arg << '\n';
+      std::exit(1);
+    }
+  }
+  return options;
+}
+
+Result
+run(const bench::Benchmark& benchmark, const std::vector<std::int64_t>& args, double min_time)
+{
+  std::string name = benchmark.get_name();
+  for (auto arg : args) {
+    name += "/" + std::to_string(arg);
+  }
+
+  std::int64_t iterations = 1;
+  for (;;) {
+    bench::State state(iterations, args);
+    benchmark.run(state);
+
+    const double seconds = state.seconds();
+    if (min_time <= seconds || 1'000'000'000 <= iterations) {
+      return Result{ name,
+                     iterations,
+                     seconds * 1e9 / iterations,
+                     state.cpu_seconds() * 1e9 / iterations,
+                     state.items() / seconds,
+                     state.bytes() / seconds,
+                     state.get_label() };
+    }
+    const double scale = seconds <= 0 ? 10.0 : std::clamp(1.4 * min_time / seconds, 2.0, 10.0);
+    iterations         = static_cast<std::int64_t>(iterations * scale);
+  }
+}
+
+std::string
+json_escape(const std::string& text)
+{
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void
+write_json(std::ostream& os, const std::vector<Result>& results)
+{
+  char              date[64];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+  os << "{\n";
+  os << "  \"context\": {\n";
+  os << "    \"date\": \"" << date << "\",\n";
+  os << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+  os << "    \"simd\": \"" << isa_name(mamePID::simd::best()) << "\",\n";
+#ifdef NDEBUG
+  os << "    \"library_build_type\": \"release\"\n";
+#else
+  os << "    \"library_build_type\": \"debug\"\n";
+#endif
+  os << "  },\n";
+  os << "  \"benchmarks\": [\n";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const auto& result = results[i];
+    os << "    {\n";
+    os << "      \"name\": \"" << json_escape(result.name) << "\",\n";
+    os << "      \"run_name\": \"" << json_escape(result.name) << "\",\n";
+    os << "      \"run_type\": \"iteration\",\n";
+    os << "      \"iterations\": " << result.iterations << ",\n";
+    os << "      \"real_time\": " << result.ns_per_iteration << ",\n";
+    os << "      \"cpu_time\": " << result.cpu_ns_per_iteration << ",\n";
+    os << "      \"time_unit\": \"ns\"";
+    if (0 < result.items_per_second) {
+      os << ",\n      \"items_per_second\": " << result.items_per_second;
+    }
+    if (0 < result.bytes_per_second) {
+      os << ",\n      \"bytes_per_second\": " << result.bytes_per_second;
+    }
+    if (!result.label.empty()) {
+      os << ",\n      \"label\": \"" << json_escape(result.label) << "\"";
+    }
+    os << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n";
+  os << "}\n";
+}
+
+void
+write_console_row(const Result& result)
+{
+  char items[32] = "";
+  if (0 < result.items_per_second) {
+    std::snprintf(items, sizeof(items), "%.4gM items/s", result.items_per_second / 1e6);
+  }
+  std::printf(
+    "%-56s %14.2f ns %12lld %18s %s\n",
+    result.name.c_str(),
+    result.ns_per_iteration,
+    static_cast<long long>(result.iterations),
+    items,
+    result.label.c_str()
+  );
+  std::fflush(stdout);
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  const Options    options = parse(argc, argv);
+  const std::regex filter(options.filter);
+  const bool       console = options.format == "console";
+
+  if (console) {
+    std::printf("simd: %s\n", isa_name(mamePID::simd::best()));
+    std::printf("%-56s %17s %12s %18s\n", "Benchmark", "Time", "Iterations", "Throughput");
+    std::printf("%s\n", std::string(106, '-').c_str());
+  }
+
+  std::vector<Result> results;
+  for (const auto* benchmark : bench::registry()) {
+    auto args = benchmark->get_args();
+    if (args.empty()) {
+      args.push_back({});
+    }
+    for (const auto& arg : args) {
+      std::string name = benchmark->get_name();
+      for (auto a : arg) {
+        name += "/" + std::to_string(a);
+      }
+      if (!std::regex_search(name, filter)) {
+        continue;
+      }
+      results.push_back(run(*benchmark, arg, options.min_time));
+      if (console) {
+        write_console_row(results.back());
+      }
+    }
+  }
+
+  if (options.format == "json") {
+    write_json(std::cout, results);
+  }
+  if (!options.out.empty()) {
+    std::ofstream out(options.out);
+    write_json(out, results);
+  }
+  return 0;
+}
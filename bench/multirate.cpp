@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <mamePID/multirate.hpp>
+
+#include "architectures.hpp"
+#include "benchmark.hpp"
+
+// One hyperperiod (100 base ticks of 100 us) of range(0) controllers, a third each at 10 kHz, 1 kHz and
+// 100 Hz. The throughput counts controller updates.
+
+namespace {
+
+constexpr std::uint64_t hyperperiod = 100;
+
+constexpr std::uint64_t
+divider(std::size_t i)
+{
+  return i % 3 == 0 ? 1 : (i % 3 == 1 ? 10 : 100);
+}
+
+constexpr std::size_t
+updates(std::size_t n)
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    total += hyperperiod / divider(i);
+  }
+  return total;
+}
+
+} // namespace
+
+// Every controller is checked on every tick.
+template<typename T, typename Architecture>
+void
+BM_multirate_polling(bench::State& state)
+{
+  const auto                 n           = static_cast<std::size_t>(state.range(0));
+  auto                       controllers = std::vector(n, Architecture::template make<T>());
+  std::vector<std::uint64_t> dividers(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    dividers[i] = divider(i);
+  }
+  std::vector<T> setpoints(n, T(1)), pvs(n, T(0)), out(n);
+  std::uint64_t  tick = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::uint64_t k = 0; k < hyperperiod; ++k, ++tick) {
+      for (std::size_t i = 0; i < n; ++i) {
+        if (tick % dividers[i] == 0) {
+          out[i] = controllers[i].calculate(setpoints[i], pvs[i]);
+        }
+      }
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * updates(n));
+}
+
+template<typename T, typename Architecture>
+void
+BM_multirate(bench::State& state)
+{
+  using namespace std::chrono_literals;
+  const auto n = static_cast<std::size_t>(state.range(0));
+  mamePID::RateScheduler<decltype(Architecture::template make<T>())> scheduler(100us);
+  for (std::size_t i = 0; i < n; ++i) {
+    scheduler.add(Architecture::template make<T>(), divider(i) * 100us);
+  }
+  std::vector<T> setpoints(n, T(1)), pvs(n, T(0)), out(n);
+  for ([[maybe_unused]] auto _ : state) {
+    for (std::uint64_t k = 0; k < hyperperiod; ++k) {
+      scheduler.tick(setpoints, pvs, out);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * updates(n));
+}
+
+BENCHMARK_TEMPLATE(BM_multirate_polling, double, bench::Pid)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_multirate, double, bench::Pid)->Range(1 << 8, 1 << 16);
@@ -0,0 +1,90 @@
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <mamePID/registry.hpp>
+
+#include "architectures.hpp"
+#include "benchmark.hpp"
+
+// A population of n controllers after churn: 2n are created, a random half is destroyed and n / 2 are
+// created again, so the heap-allocated objects end up scattered over freed blocks.
+
+namespace {
+
+constexpr std::int64_t max_loops = 1 << 20;
+
+template<typename Insert, typename Erase>
+void
+churn(std::size_t n, Insert insert, Erase erase)
+{
+  std::mt19937 rng(1);
+  for (std::size_t i = 0; i < 2 * n; ++i) {
+    insert();
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    erase(rng);
+  }
+  for (std::size_t i = 0; i < n / 2; ++i) {
+    insert();
+  }
+}
+
+} // namespace
+
+template<typename T>
+void
+BM_registry(bench::State& state)
+{
+  using Controller = decltype(bench::Pid::make<T>());
+  const auto                               n = static_cast<std::size_t>(state.range(0));
+  mamePID::ControllerPool<Controller>      pool;
+  std::vector<mamePID::Handle<Controller>> handles;
+  churn(
+    n,
+    [&] { handles.push_back(pool.insert(bench::Pid::make<T>())); },
+    [&](std::mt19937& rng) {
+      const auto i = std::uniform_int_distribution<std::size_t>(0, handles.size() - 1)(rng);
+      pool.erase(handles[i]);
+      handles[i] = handles.back();
+      handles.pop_back();
+    });
+
+  T pv{};
+  for ([[maybe_unused]] auto _ : state) {
+    for (auto& controller : pool) {
+      pv = controller.calculate(T(1), pv);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * pool.size());
+}
+
+template<typename T>
+void
+BM_heap_objects(bench::State& state)
+{
+  using Controller = decltype(bench::Pid::make<T>());
+  const auto                               n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::unique_ptr<Controller>> controllers;
+  churn(
+    n,
+    [&] { controllers.push_back(std::make_unique<Controller>(bench::Pid::make<T>())); },
+    [&](std::mt19937& rng) {
+      const auto i   = std::uniform_int_distribution<std::size_t>(0, controllers.size() - 1)(rng);
+      controllers[i] = std::move(controllers.back());
+      controllers.pop_back();
+    });
+
+  T pv{};
+  for ([[maybe_unused]] auto _ : state) {
+    for (auto& controller : controllers) {
+      pv = controller->calculate(T(1), pv);
+    }
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * controllers.size());
+}
+
+BENCHMARK_TEMPLATE(BM_registry, double)->Range(1 << 6, max_loops);
+BENCHMARK_TEMPLATE(BM_heap_objects, double)->Range(1 << 6, max_loops);
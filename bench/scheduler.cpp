@@ -0,0 +1,34 @@
+#include <random>
+#include <span>
+#include <vector>
+
+#include <mamePID/scheduler.hpp>
+
+#include "architectures.hpp"
+#include "benchmark.hpp"
+
+// One scheduler tick over n individual PID objects on all hardware threads.
+template<typename T, typename Architecture>
+void
+BM_scheduler(bench::State& state)
+{
+  const auto                        n           = static_cast<std::size_t>(state.range(0));
+  const auto                        controllers = std::vector(n, Architecture::template make<T>());
+  std::mt19937                      rng(1);
+  std::uniform_real_distribution<T> signal(-1.0, 1.0);
+  std::vector<T>                    setpoints(n), pvs(n), out(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    setpoints[i] = signal(rng);
+    pvs[i]       = signal(rng);
+  }
+
+  mamePID::Scheduler scheduler{ std::span(controllers) };
+  for ([[maybe_unused]] auto _ : state) {
+    scheduler.tick(setpoints, pvs, out);
+    bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.max_iterations() * n);
+  state.SetLabel(std::to_string(scheduler.workers()) + " workers");
+}
+
+BENCHMARK_TEMPLATE(BM_scheduler, double, bench::Pid)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,82 @@
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <mamePID/simulation.hpp>
+
+#include "benchmark.hpp"
+
+// A tuning sweep of range(0) PID candidates over 1000 steps of a first-order plus dead time model.
+
+namespace {
+
+constexpr std::size_t steps = 1000;
+
+template<typename T>
+std::vector<mamePID::Gains<T>>
+candidates(std::size_t n)
+{
+  std::vector<mamePID::Gains<T>> gains(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    gains[i] = { T(0.1) + T(0.001) * T(i % 1000), T(0.5) + T(0.01) * T(i / 1000), T(0.001) * T(i % 7) };
+  }
+  return gains;
+}
+
+} // namespace
+
+// One candidate at a time, the feedback loop written out by hand with the costs accumulated per step.
+template<typename T>
+void
+BM_sweep_objects(bench::State& state)
+{
+  const auto gains = candidates<T>(state.range(0));
+  const auto model = mamePID::first_order_dead_time(T(1.2), T(0.3), T(0.05), T(0.01));
+  for ([[maybe_unused]] auto _ : state) {
+    for (const auto& g : gains) {
+      auto                  pid = mamePID::pid<T>(g.kp, g.ki, g.kd, T(0.01), T(-5), T(5));
+      mamePID::PlantBank<T> plant(model, 1);
+      std::array<T, 1>      u{}, y{};
+      T                     iae{};
+      for (std::size_t k = 0; k < steps; ++k) {
+        u[0] = pid.calculate(T(1), y[0]);
+        plant.step(u, y);
+        iae += std::abs(T(1) - y[0]) * T(0.01);
+      }
+      bench::DoNotOptimize(iae);
+    }
+  }
+  state.SetItemsProcessed(state.max_iterations() * gains.size() * steps);
+}
+
+template<typename T>
+void
+BM_sweep(bench::State& state)
+{
+  const auto                     gains = candidates<T>(state.range(0));
+  const auto                     model = mamePID::first_order_dead_time(T(1.2), T(0.3), T(0.05), T(0.01));
+  const mamePID::SweepOptions<T> options{ .steps = steps, .min = T(-5), .max = T(5), .threads = 1 };
+  for ([[maybe_unused]] auto _ : state) {
+    auto costs = mamePID::sweep(std::span(gains), model, options);
+    bench::DoNotOptimize(costs.data());
+  }
+  state.SetItemsProcessed(state.max_iterations() * gains.size() * steps);
+}
+
+template<typename T>
+void
+BM_sweep_threaded(bench::State& state)
+{
+  const auto                     gains = candidates<T>(state.range(0));
+  const auto                     model = mamePID::first_order_dead_time(T(1.2), T(0.3), T(0.05), T(0.01));
+  const mamePID::SweepOptions<T> options{ .steps = steps, .min = T(-5), .max = T(5) };
+  for ([[maybe_unused]] auto _ : state) {
+    auto costs = mamePID::sweep(std::span(gains), model, options);
+    bench::DoNotOptimize(costs.data());
+  }
+  state.SetItemsProcessed(state.max_iterations() * gains.size() * steps);
+}
+
+BENCHMARK_TEMPLATE(BM_sweep_objects, double)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_sweep, double)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_sweep_threaded, double)->Range(1 << 8, 1 << 14);
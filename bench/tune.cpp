@@ -0,0 +1,25 @@
+#include <mamePID/tune.hpp>
+
+#include "benchmark.hpp"
+
+// One refine() run on a first-order plus dead time model with trajectories of range(0) steps; the
+// throughput counts simulated candidate trajectories.
+template<typename T>
+void
+BM_refine(bench::State& state)
+{
+  const mamePID::Fopdt<T> plant{ T(1.2), T(0.5), T(0.1) };
+  const auto              model   = plant.model(T(0.01));
+  const auto              initial = mamePID::imc(plant, T(0.5));
+  mamePID::TuneOptions<T> options;
+  options.simulation = { .steps = static_cast<std::size_t>(state.range(0)), .min = T(-10), .max = T(10) };
+  std::size_t evaluations = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    const auto result = mamePID::refine(initial, model, options);
+    evaluations += result.evaluations;
+    bench::DoNotOptimize(result.objective);
+  }
+  state.SetItemsProcessed(evaluations);
+}
+
+BENCHMARK_TEMPLATE(BM_refine, double)->Arg(100)->Arg(300)->Arg(1000);
@@ -1,7 +1,14 @@
 #ifndef MAMEPID_HPP_
 #define MAMEPID_HPP_
 
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <concepts>
+#include <cstddef>
 #include <limits>
+#include <span>
+#include <type_traits>
 
 namespace mamePID {
 
@@ -11,187 +18,1300 @@ concept Component = requires(T t) {
   requires std::is_convertible_v<typename T::value_type, U>;
 };
 
+// Components that are told the unclamped and clamped controller output after every update.
 template<typename T>
-concept CoeffMutable = requires(T t) {
-  { t.set } -> std::invocable<T, typename T::value_type>;
+concept SaturationFeedback = requires(T t, typename T::value_type v) { t.feedback(v, v); };
+
+// Components that accept the sampling period of each update, for loops with jittery sample times.
+template<typename T>
+concept VariableStep = requires(T t, typename T::value_type v) { t.calculate(v, v, v); };
+
+template<typename T>
+concept CoeffMutable = requires(T t, typename T::value_type k) { t.set(k); };
+
+// Type the Integral component accumulates in. Wider than T for fixed-point types.
+template<typename T>
+struct accumulator
+{
+  using type = T;
+};
+
+template<typename T>
+using accumulator_t = typename accumulator<T>::type;
+
+template<typename T>
+struct Gains
+{
+  T kp;
+  T ki;
+  T kd;
+};
+
+// Setpoint weights of a two-degree-of-freedom controller: the P term acts on b * setpoint - pv and the D
+// term on c * setpoint - pv.
+template<typename T>
+struct Weights
+{
+  T b;
+  T c;
+};
+
+// Contributions of each term to one controller update, before and after the output clamp.
+template<typename T>
+struct Terms
+{
+  T p;
+  T i;
+  T d;
+  T unclamped;
+  T output;
+};
+
+// Transfer functions of a component or controller in the linear region, evaluated at z: the output is
+// setpoint * R(z) - pv * Y(z), with R in setpoint and Y in feedback. Y is the controller of the loop seen
+// by the process, R differs from it by the setpoint weighting of the architecture.
+template<typename T>
+struct Response
+{
+  std::complex<T> setpoint;
+  std::complex<T> feedback;
+};
+
+template<typename T>
+class Zero
+{
+public:
+  using value_type = T;
+
+  constexpr Zero() {}
+
+  constexpr T    calculate(T, T) { return T{}; }
+  constexpr T    calculate(T, T, T) { return T{}; }
+  constexpr void set(T) {}
+
+  constexpr Response<T> response(std::complex<T>) const
+    requires std::floating_point<T>
+  {
+    return {};
+  }
+};
+
+template<typename T>
+class Proportional
+{
+public:
+  using value_type = T;
+
+  constexpr Proportional(T kp, T)
+    : kp(kp)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T error = setpoint - pv;
+    return kp * error;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T) { return calculate(setpoint, pv); }
+
+  constexpr void set(T kp) { this->kp = kp; }
+
+  constexpr Response<T> response(std::complex<T>) const
+    requires std::floating_point<T>
+  {
+    return { kp, kp };
+  }
+
+private:
+  T kp;
+};
+
+// Accumulator of the integral term, clamped to [minv, maxv]. The anti-windup policy decides whether an
+// error is integrated, and may react to the saturation of the controller output reported through
+// feedback() by returning a correction that is added to the accumulator.
+template<typename T, typename AntiWindup>
+class BasicIntegral
+{
+public:
+  using value_type = T;
+
+  // Arguments after maxv are passed on to the policy.
+  template<typename... Args>
+  constexpr BasicIntegral(
+    T ki,
+    T dt,
+    T minv = std::numeric_limits<T>::lowest(),
+    T maxv = std::numeric_limits<T>::max(),
+    Args... args
+  )
+    : rate(ki)
+    , ki(rate * accumulator_t<T>(dt))
+    , dt(dt)
+    , minv(minv)
+    , maxv(maxv)
+    , integral(0)
+    , policy(args...)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv) { return integrate(ki, setpoint - pv); }
+
+  // Scales the unscaled gain rather than ki by dt / this->dt, so the fixed-point accumulator, e.g. [-2, 2)
+  // for Q15, does not saturate on a ratio when dt is more than twice the nominal period.
+  constexpr T calculate(T setpoint, T pv, T dt)
+  {
+    return integrate(rate * accumulator_t<T>(dt), setpoint - pv);
+  }
+
+  constexpr void feedback(T unclamped, T output)
+    requires requires(AntiWindup p) { p.feedback(unclamped, output); }
+  {
+    using A  = accumulator_t<T>;
+    integral = std::clamp(integral + policy.feedback(unclamped, output), A(minv), A(maxv));
+  }
+
+  constexpr void set(T ki)
+  {
+    rate     = accumulator_t<T>(ki);
+    this->ki = rate * accumulator_t<T>(dt);
+  }
+
+  constexpr bool saturated() const
+  {
+    return integral <= accumulator_t<T>(minv) || accumulator_t<T>(maxv) <= integral;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto i = T(ki) * z / (z - T(1));
+    return { i, i };
+  }
+
+private:
+  constexpr T integrate(accumulator_t<T> gain, T error)
+  {
+    using A = accumulator_t<T>;
+    if (policy.integrates(error)) {
+      integral += gain * A(error);
+      integral  = std::clamp(integral, A(minv), A(maxv));
+    }
+    return T(integral);
+  }
+
+  accumulator_t<T>                 rate;
+  accumulator_t<T>                 ki;
+  T                                dt;
+  T                                minv;
+  T                                maxv;
+  accumulator_t<T>                 integral;
+  [[no_unique_address]] AntiWindup policy;
+};
+
+// Anti-windup policies. Clamping only limits the accumulator to [minv, maxv]; the others also use the
+// saturation of the controller output.
+template<typename T>
+struct Clamping
+{
+  constexpr bool integrates(T) const { return true; }
+};
+
+// Back-calculation: after each update, kb * (output - unclamped) is added to the accumulator. kb = 1
+// pulls the output back onto the limit in one step; smaller values track more slowly.
+template<typename T>
+struct BackCalculation
+{
+  constexpr BackCalculation(T kb = T(1))
+    : kb(kb)
+  {
+  }
+
+  constexpr bool integrates(T) const { return true; }
+
+  constexpr accumulator_t<T> feedback(T unclamped, T output) const
+  {
+    return accumulator_t<T>(kb) * accumulator_t<T>(output - unclamped);
+  }
+
+  T kb;
+};
+
+// Conditional integration: while the previous output was clamped, errors that would drive it further
+// into the limit are not integrated.
+template<typename T>
+struct ConditionalIntegration
+{
+  constexpr bool integrates(T error) const
+  {
+    return !(T(0) < excess && T(0) < error) && !(excess < T(0) && error < T(0));
+  }
+
+  constexpr accumulator_t<T> feedback(T unclamped, T output)
+  {
+    excess = unclamped - output;
+    return accumulator_t<T>(0);
+  }
+
+  T excess = T(0);
+};
+
+// Integrator freeze: nothing is integrated while the previous output was clamped.
+template<typename T>
+struct IntegratorFreeze
+{
+  constexpr bool integrates(T) const { return !clamped; }
+
+  constexpr accumulator_t<T> feedback(T unclamped, T output)
+  {
+    clamped = unclamped != output;
+    return accumulator_t<T>(0);
+  }
+
+  bool clamped = false;
+};
+
+template<typename T>
+using Integral = BasicIntegral<T, Clamping<T>>;
+
+template<typename T>
+using BackCalculationIntegral = BasicIntegral<T, BackCalculation<T>>;
+
+template<typename T>
+using ConditionalIntegral = BasicIntegral<T, ConditionalIntegration<T>>;
+
+template<typename T>
+using FreezingIntegral = BasicIntegral<T, IntegratorFreeze<T>>;
+
+template<typename T>
+class Derivative
+{
+public:
+  using value_type = T;
+
+  constexpr Derivative(T kd, T dt)
+    : raw_kd(kd)
+    , kd(kd / dt)
+    , dt(dt)
+    , pre_error(0)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T error      = setpoint - pv;
+    const T derivative = error - pre_error;
+    pre_error          = error;
+    return kd * derivative;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T dt)
+  {
+    const T error      = setpoint - pv;
+    const T derivative = error - pre_error;
+    pre_error          = error;
+    return raw_kd / dt * derivative;
+  }
+
+  constexpr void set(T kd)
+  {
+    raw_kd   = kd;
+    this->kd = kd / dt;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto d = kd * (T(1) - T(1) / z);
+    return { d, d };
+  }
+
+private:
+  T raw_kd;
+  T kd;
+  T dt;
+  T pre_error;
+};
+
+template<typename T>
+class PrecedingProportional
+{
+public:
+  using value_type = T;
+
+  constexpr PrecedingProportional(T kp, T)
+    : kp(kp)
+  {
+  }
+
+  constexpr T calculate(T, T pv) { return -kp * pv; }
+  constexpr T calculate(T, T pv, T) { return -kp * pv; }
+
+  constexpr void set(T kp) { this->kp = kp; }
+
+  constexpr Response<T> response(std::complex<T>) const
+    requires std::floating_point<T>
+  {
+    return { T(0), kp };
+  }
+
+private:
+  T kp;
+};
+
+template<typename T>
+class PrecedingDerivative
+{
+public:
+  using value_type = T;
+  constexpr PrecedingDerivative(T kd, T dt)
+    : raw_kd(kd)
+    , kd(kd / dt)
+    , dt(dt)
+    , pre_pv(0)
+  {
+  }
+
+  constexpr T calculate(T, T pv)
+  {
+    const T derivative = pv - pre_pv;
+    pre_pv             = pv;
+    return -kd * derivative;
+  }
+
+  constexpr T calculate(T, T pv, T dt)
+  {
+    const T derivative = pv - pre_pv;
+    pre_pv             = pv;
+    return -(raw_kd / dt) * derivative;
+  }
+
+  constexpr void set(T kd)
+  {
+    raw_kd   = kd;
+    this->kd = kd / dt;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    return { T(0), kd * (T(1) - T(1) / z) };
+  }
+
+private:
+  T raw_kd;
+  T kd;
+  T dt;
+  T pre_pv;
+};
+
+// Proportional and derivative terms with setpoint weights b and c. b = c = 1 is PID, c = 0 is PI-D and
+// b = c = 0 is I-PD, with the same rounding as the dedicated components.
+template<typename T>
+class WeightedProportional
+{
+public:
+  using value_type = T;
+
+  constexpr WeightedProportional(T kp, T, T b)
+    : kp(kp)
+    , b(b)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T error = b * setpoint - pv;
+    return kp * error;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T) { return calculate(setpoint, pv); }
+
+  constexpr void set(T kp) { this->kp = kp; }
+  constexpr void set_weight(T b) { this->b = b; }
+
+  constexpr Response<T> response(std::complex<T>) const
+    requires std::floating_point<T>
+  {
+    return { kp * b, kp };
+  }
+
+private:
+  T kp;
+  T b;
+};
+
+template<typename T>
+class WeightedDerivative
+{
+public:
+  using value_type = T;
+
+  constexpr WeightedDerivative(T kd, T dt, T c)
+    : raw_kd(kd)
+    , kd(kd / dt)
+    , c(c)
+    , dt(dt)
+    , pre_error(0)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T error      = c * setpoint - pv;
+    const T derivative = error - pre_error;
+    pre_error          = error;
+    return kd * derivative;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T dt)
+  {
+    const T error      = c * setpoint - pv;
+    const T derivative = error - pre_error;
+    pre_error          = error;
+    return raw_kd / dt * derivative;
+  }
+
+  constexpr void set(T kd)
+  {
+    raw_kd   = kd;
+    this->kd = kd / dt;
+  }
+  constexpr void set_weight(T c) { this->c = c; }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto d = kd * (T(1) - T(1) / z);
+    return { c * d, d };
+  }
+
+private:
+  T raw_kd;
+  T kd;
+  T c;
+  T dt;
+  T pre_error;
+};
+
+// Derivative through the first-order low-pass kd * s / (1 + s * tf) with tf = kd / (kp * n), discretized
+// with backward Euler. Larger n filters less; n = infinity is the raw backward difference of Derivative, and
+// so is kp = 0, which leaves no proportional gain to scale the filter by. set_kp() follows changes of kp.
+template<typename T>
+class FilteredDerivative
+{
+public:
+  using value_type = T;
+
+  constexpr FilteredDerivative(T kd, T dt, T kp, T n)
+    : kd(kd)
+    , kp(kp)
+    , n(n)
+    , dt(dt)
+    , pre_error(0)
+    , filtered(0)
+  {
+    update();
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T error = setpoint - pv;
+    filtered      = a * filtered + b * (error - pre_error);
+    pre_error     = error;
+    return filtered;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T dt)
+  {
+    const T error = setpoint - pv;
+    filtered      = (tf * filtered + kd * (error - pre_error)) / (tf + dt);
+    pre_error     = error;
+    return filtered;
+  }
+
+  constexpr void set(T kd)
+  {
+    this->kd = kd;
+    update();
+  }
+
+  constexpr void set_kp(T kp)
+  {
+    this->kp = kp;
+    update();
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto d = b * (z - T(1)) / (z - a);
+    return { d, d };
+  }
+
+private:
+  constexpr void update()
+  {
+    tf = kp == T(0) ? T(0) : kd / (kp * n);
+    a  = tf / (tf + dt);
+    b  = kd / (tf + dt);
+  }
+
+  T a;
+  T b;
+  T tf;
+  T kd;
+  T kp;
+  T n;
+  T dt;
+  T pre_error;
+  T filtered;
+};
+
+template<typename T>
+class PrecedingFilteredDerivative
+{
+public:
+  using value_type = T;
+
+  constexpr PrecedingFilteredDerivative(T kd, T dt, T kp, T n)
+    : kd(kd)
+    , kp(kp)
+    , n(n)
+    , dt(dt)
+    , pre_pv(0)
+    , filtered(0)
+  {
+    update();
+  }
+
+  constexpr T calculate(T, T pv)
+  {
+    filtered = a * filtered - b * (pv - pre_pv);
+    pre_pv   = pv;
+    return filtered;
+  }
+
+  constexpr T calculate(T, T pv, T dt)
+  {
+    filtered = (tf * filtered - kd * (pv - pre_pv)) / (tf + dt);
+    pre_pv   = pv;
+    return filtered;
+  }
+
+  constexpr void set(T kd)
+  {
+    this->kd = kd;
+    update();
+  }
+
+  constexpr void set_kp(T kp)
+  {
+    this->kp = kp;
+    update();
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    return { T(0), b * (z - T(1)) / (z - a) };
+  }
+
+private:
+  constexpr void update()
+  {
+    tf = kp == T(0) ? T(0) : kd / (kp * n);
+    a  = tf / (tf + dt);
+    b  = kd / (tf + dt);
+  }
+
+  T a;
+  T b;
+  T tf;
+  T kd;
+  T kp;
+  T n;
+  T dt;
+  T pre_pv;
+  T filtered;
+};
+
+// Components of the velocity form. They return the change of their term since the previous update
+// rather than the term itself, so none of them holds an accumulator.
+template<typename T>
+class VelocityProportional
+{
+public:
+  using value_type = T;
+
+  constexpr VelocityProportional(T kp, T)
+    : kp(kp)
+    , pre_error(0)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T error = setpoint - pv;
+    const T delta = error - pre_error;
+    pre_error     = error;
+    return kp * delta;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T) { return calculate(setpoint, pv); }
+
+  constexpr void set(T kp) { this->kp = kp; }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto p = kp * (T(1) - T(1) / z);
+    return { p, p };
+  }
+
+private:
+  T kp;
+  T pre_error;
+};
+
+template<typename T>
+class VelocityPrecedingProportional
+{
+public:
+  using value_type = T;
+
+  constexpr VelocityPrecedingProportional(T kp, T)
+    : kp(kp)
+    , pre_pv(0)
+  {
+  }
+
+  constexpr T calculate(T, T pv)
+  {
+    const T delta = pv - pre_pv;
+    pre_pv        = pv;
+    return -kp * delta;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T) { return calculate(setpoint, pv); }
+
+  constexpr void set(T kp) { this->kp = kp; }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    return { T(0), kp * (T(1) - T(1) / z) };
+  }
+
+private:
+  T kp;
+  T pre_pv;
+};
+
+template<typename T>
+class VelocityIntegral
+{
+public:
+  using value_type = T;
+
+  constexpr VelocityIntegral(T ki, T dt)
+    : rate(ki)
+    , ki(ki * dt)
+    , dt(dt)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T error = setpoint - pv;
+    return ki * error;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T dt)
+  {
+    const T error = setpoint - pv;
+    return rate * dt * error;
+  }
+
+  constexpr void set(T ki)
+  {
+    rate     = ki;
+    this->ki = ki * dt;
+  }
+
+  constexpr Response<T> response(std::complex<T>) const
+    requires std::floating_point<T>
+  {
+    return { ki, ki };
+  }
+
+private:
+  T rate;
+  T ki;
+  T dt;
+};
+
+template<typename T>
+class VelocityDerivative
+{
+public:
+  using value_type = T;
+
+  constexpr VelocityDerivative(T kd, T dt)
+    : raw_kd(kd)
+    , kd(kd / dt)
+    , dt(dt)
+    , pre_error(0)
+    , pre_term(0)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv) { return step(kd, setpoint - pv); }
+  constexpr T calculate(T setpoint, T pv, T dt) { return step(raw_kd / dt, setpoint - pv); }
+
+  constexpr void set(T kd)
+  {
+    raw_kd   = kd;
+    this->kd = kd / dt;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto x = T(1) - T(1) / z;
+    return { kd * x * x, kd * x * x };
+  }
+
+private:
+  // Change of the positional derivative term, so that samples of different length can follow each other.
+  constexpr T step(T gain, T error)
+  {
+    const T term  = gain * (error - pre_error);
+    const T delta = term - pre_term;
+    pre_error     = error;
+    pre_term      = term;
+    return delta;
+  }
+
+  T raw_kd;
+  T kd;
+  T dt;
+  T pre_error;
+  T pre_term;
 };
 
 template<typename T>
-class Zero
+class VelocityPrecedingDerivative
 {
 public:
   using value_type = T;
 
-  Zero() {}
+  constexpr VelocityPrecedingDerivative(T kd, T dt)
+    : raw_kd(kd)
+    , kd(kd / dt)
+    , dt(dt)
+    , pre_pv(0)
+    , pre_term(0)
+  {
+  }
+
+  constexpr T calculate(T, T pv) { return step(kd, pv); }
+  constexpr T calculate(T, T pv, T dt) { return step(raw_kd / dt, pv); }
+
+  constexpr void set(T kd)
+  {
+    raw_kd   = kd;
+    this->kd = kd / dt;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto x = T(1) - T(1) / z;
+    return { T(0), kd * x * x };
+  }
+
+private:
+  constexpr T step(T gain, T pv)
+  {
+    const T term  = -gain * (pv - pre_pv);
+    const T delta = term - pre_term;
+    pre_pv        = pv;
+    pre_term      = term;
+    return delta;
+  }
 
-  T    calculate(T, T) { return 0.0; }
-  void set(T) {}
+  T raw_kd;
+  T kd;
+  T dt;
+  T pre_pv;
+  T pre_term;
 };
 
-template<typename T>
-class Proportional
+// Components with their gains and sampling period as template parameters. Gain products are folded at
+// compile time, leaving only the controller state in the object.
+template<typename T, T kp>
+class StaticProportional
 {
 public:
   using value_type = T;
 
-  Proportional(T kp, T)
-    : kp(kp)
-  {
-  }
+  constexpr StaticProportional() {}
 
-  T calculate(T setpoint, T pv)
+  constexpr T calculate(T setpoint, T pv)
   {
     const T error = setpoint - pv;
     return kp * error;
   }
 
-private:
-  const T kp;
+  constexpr T calculate(T setpoint, T pv, T) { return calculate(setpoint, pv); }
+
+  constexpr Response<T> response(std::complex<T>) const
+    requires std::floating_point<T>
+  {
+    return { kp, kp };
+  }
 };
 
-template<typename T>
-class Integral
+template<typename T, T ki, T dt, T minv, T maxv>
+class StaticIntegral
 {
 public:
   using value_type = T;
-  Integral(T ki, T dt, T minv = std::numeric_limits<T>::lowest(), T maxv = std::numeric_limits<T>::max())
-    : ki(ki * dt)
-    , minv(minv)
-    , maxv(maxv)
-    , integral(0)
+
+  constexpr StaticIntegral()
+    : integral(0)
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
   {
+    using A        = accumulator_t<T>;
+    const T error  = setpoint - pv;
+    integral      += gain * A(error);
+    integral       = std::clamp(integral, A(minv), A(maxv));
+    return T(integral);
   }
 
-  T calculate(T setpoint, T pv)
+  constexpr T calculate(T setpoint, T pv, T period)
   {
+    using A        = accumulator_t<T>;
     const T error  = setpoint - pv;
-    integral      += ki * error;
-    integral       = std::clamp(integral, minv, maxv);
-    return integral;
+    integral      += A(ki) * A(period) * A(error);
+    integral       = std::clamp(integral, A(minv), A(maxv));
+    return T(integral);
+  }
+
+  constexpr bool saturated() const
+  {
+    return integral <= accumulator_t<T>(minv) || accumulator_t<T>(maxv) <= integral;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto i = T(gain) * z / (z - T(1));
+    return { i, i };
   }
 
 private:
-  const T ki;
-  const T minv;
-  const T maxv;
-  T       integral;
+  static constexpr accumulator_t<T> gain = accumulator_t<T>(ki) * accumulator_t<T>(dt);
+
+  accumulator_t<T> integral;
 };
 
-template<typename T>
-class Derivative
+template<typename T, T kd, T dt>
+class StaticDerivative
 {
 public:
   using value_type = T;
 
-  Derivative(T kd, T dt)
-    : kd(kd / dt)
-    , pre_error(0)
+  constexpr StaticDerivative()
+    : pre_error(0)
   {
   }
 
-  T calculate(T setpoint, T pv)
+  constexpr T calculate(T setpoint, T pv)
   {
     const T error      = setpoint - pv;
     const T derivative = error - pre_error;
     pre_error          = error;
-    return kd * derivative;
+    return gain * derivative;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T period)
+  {
+    const T error      = setpoint - pv;
+    const T derivative = error - pre_error;
+    pre_error          = error;
+    return kd / period * derivative;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto d = gain * (T(1) - T(1) / z);
+    return { d, d };
   }
 
 private:
-  const T kd;
-  T       pre_error;
+  static constexpr T gain = kd / dt;
+
+  T pre_error;
 };
 
-template<typename T>
-class PrecedingProportional
+template<typename T, T kp>
+class StaticPrecedingProportional
 {
 public:
   using value_type = T;
 
-  PrecedingProportional(T kp, T)
-    : kp(kp)
-  {
-  }
+  constexpr StaticPrecedingProportional() {}
 
-  T calculate(T, T pv) { return -kp * pv; }
+  constexpr T calculate(T, T pv) { return -kp * pv; }
+  constexpr T calculate(T, T pv, T) { return -kp * pv; }
 
-private:
-  const T kp;
+  constexpr Response<T> response(std::complex<T>) const
+    requires std::floating_point<T>
+  {
+    return { T(0), kp };
+  }
 };
 
-template<typename T>
-class PrecedingDerivative
+template<typename T, T kd, T dt>
+class StaticPrecedingDerivative
 {
 public:
   using value_type = T;
-  PrecedingDerivative(T kd, T dt)
-    : kd(kd / dt)
-    , pre_pv(0)
+
+  constexpr StaticPrecedingDerivative()
+    : pre_pv(0)
   {
   }
 
-  T calculate(T, T pv)
+  constexpr T calculate(T, T pv)
   {
     const T derivative = pv - pre_pv;
     pre_pv             = pv;
-    return -kd * derivative;
+    return -gain * derivative;
+  }
+
+  constexpr T calculate(T, T pv, T period)
+  {
+    const T derivative = pv - pre_pv;
+    pre_pv             = pv;
+    return -(kd / period) * derivative;
+  }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    return { T(0), gain * (T(1) - T(1) / z) };
+  }
+
+private:
+  static constexpr T gain = kd / dt;
+
+  T pre_pv;
+};
+
+template<typename T>
+class Limits
+{
+public:
+  using value_type = T;
+
+  constexpr Limits(T minv, T maxv)
+    : minv(minv)
+    , maxv(maxv)
+  {
   }
 
+  constexpr T min() const { return minv; }
+  constexpr T max() const { return maxv; }
+
 private:
-  const T kd;
-  T       pre_pv;
+  T minv;
+  T maxv;
+};
+
+template<typename T, T minv, T maxv>
+class StaticLimits
+{
+public:
+  using value_type = T;
+
+  constexpr StaticLimits() {}
+
+  constexpr T min() const { return minv; }
+  constexpr T max() const { return maxv; }
 };
 
-template<typename T, Component<T> ProportionalT, Component<T> IntegralT, Component<T> DerivativeT>
+template<
+  typename T,
+  Component<T> ProportionalT,
+  Component<T> IntegralT,
+  Component<T> DerivativeT,
+  typename LimitsT = Limits<T>>
 class PID
 {
 public:
   using value_type = T;
 
-  PID(ProportionalT proportional, IntegralT integral, DerivativeT derivative, T min, T max)
+  constexpr PID(ProportionalT proportional, IntegralT integral, DerivativeT derivative, T min, T max)
+    requires std::constructible_from<LimitsT, T, T>
+    : proportional(proportional)
+    , integral(integral)
+    , derivative(derivative)
+    , limits(min, max)
+  {
+  }
+
+  constexpr PID(ProportionalT proportional, IntegralT integral, DerivativeT derivative)
+    requires std::default_initializable<LimitsT>
     : proportional(proportional)
     , integral(integral)
     , derivative(derivative)
-    , min(min)
-    , max(max)
   {
   }
 
-  T calculate(T setpoint, T pv)
+  constexpr T calculate(T setpoint, T pv)
   {
     T output = proportional.calculate(setpoint, pv) + integral.calculate(setpoint, pv) +
                derivative.calculate(setpoint, pv);
-    return std::clamp(output, min, max);
+    if constexpr (SaturationFeedback<IntegralT>) {
+      const T unclamped = output;
+      output            = std::clamp(unclamped, limits.min(), limits.max());
+      integral.feedback(unclamped, output);
+      return output;
+    } else {
+      return std::clamp(output, limits.min(), limits.max());
+    }
+  }
+
+  // Update for a sample that arrives dt after the previous one instead of the nominal sampling period.
+  constexpr T calculate(T setpoint, T pv, T dt)
+    requires VariableStep<ProportionalT> && VariableStep<IntegralT> && VariableStep<DerivativeT>
+  {
+    T output = proportional.calculate(setpoint, pv, dt) + integral.calculate(setpoint, pv, dt) +
+               derivative.calculate(setpoint, pv, dt);
+    if constexpr (SaturationFeedback<IntegralT>) {
+      const T unclamped = output;
+      output            = std::clamp(unclamped, limits.min(), limits.max());
+      integral.feedback(unclamped, output);
+      return output;
+    } else {
+      return std::clamp(output, limits.min(), limits.max());
+    }
+  }
+
+  // Same update as calculate(), also returning the individual terms.
+  constexpr Terms<T> calculate_terms(T setpoint, T pv)
+  {
+    const T p         = proportional.calculate(setpoint, pv);
+    const T i         = integral.calculate(setpoint, pv);
+    const T d         = derivative.calculate(setpoint, pv);
+    const T unclamped = p + i + d;
+    const T output    = std::clamp(unclamped, limits.min(), limits.max());
+    if constexpr (SaturationFeedback<IntegralT>) {
+      integral.feedback(unclamped, output);
+    }
+    return { p, i, d, unclamped, output };
+  }
+
+  constexpr bool integral_saturated() const
+  {
+    if constexpr (requires { integral.saturated(); }) {
+      return integral.saturated();
+    } else {
+      return false;
+    }
+  }
+
+  constexpr T min() const { return limits.min(); }
+  constexpr T max() const { return limits.max(); }
+
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto p = proportional.response(z);
+    const auto i = integral.response(z);
+    const auto d = derivative.response(z);
+    return { p.setpoint + i.setpoint + d.setpoint, p.feedback + i.feedback + d.feedback };
+  }
+
+  // Steps the controller once per sample: out[k] = calculate(setpoints[k], pvs[k]).
+  // The controller is copied to a local for the whole span, so its state stays in registers instead of
+  // being reloaded after every store to out.
+  constexpr void run(std::span<const T> setpoints, std::span<const T> pvs, std::span<T> out)
+  {
+    assert(setpoints.size() == pvs.size() && out.size() == pvs.size());
+
+    PID controller = *this;
+    for (std::size_t k = 0; k < out.size(); ++k) {
+      out[k] = controller.calculate(setpoints[k], pvs[k]);
+    }
+    *this = controller;
+  }
+
+  // Closed-loop variant: the control output is fed to plant, whose return value is the process value of
+  // the next step. out[k] receives the process value after step k. Returns the final process value.
+  template<std::invocable<T> Plant>
+    requires std::convertible_to<std::invoke_result_t<Plant&, T>, T>
+  constexpr T run(std::span<const T> setpoints, T pv, Plant&& plant, std::span<T> out)
+  {
+    assert(out.size() == setpoints.size());
+
+    PID controller = *this;
+    for (std::size_t k = 0; k < out.size(); ++k) {
+      pv     = plant(controller.calculate(setpoints[k], pv));
+      out[k] = pv;
+    }
+    *this = controller;
+    return pv;
+  }
+
+  constexpr void setKp(T kp)
+    requires CoeffMutable<ProportionalT>
+  {
+    proportional.set(kp);
+    if constexpr (requires { derivative.set_kp(kp); }) {
+      derivative.set_kp(kp);
+    }
+  }
+
+  constexpr void setKi(T ki)
+    requires CoeffMutable<IntegralT>
+  {
+    integral.set(ki);
+  }
+
+  constexpr void setKd(T kd)
+    requires CoeffMutable<DerivativeT>
+  {
+    derivative.set(kd);
+  }
+
+  constexpr void setGains(const Gains<T>& gains)
+    requires CoeffMutable<ProportionalT> && CoeffMutable<IntegralT> && CoeffMutable<DerivativeT>
+  {
+    proportional.set(gains.kp);
+    integral.set(gains.ki);
+    if constexpr (requires { derivative.set_kp(gains.kp); }) {
+      derivative.set_kp(gains.kp);
+    }
+    derivative.set(gains.kd);
+  }
+
+  constexpr void setWeights(const Weights<T>& weights)
+    requires std::same_as<ProportionalT, WeightedProportional<T>> &&
+             std::same_as<DerivativeT, WeightedDerivative<T>>
+  {
+    proportional.set_weight(weights.b);
+    derivative.set_weight(weights.c);
+  }
+
+private:
+  [[no_unique_address]] ProportionalT proportional;
+  [[no_unique_address]] IntegralT     integral;
+  [[no_unique_address]] DerivativeT   derivative;
+  [[no_unique_address]] LimitsT       limits;
+};
+
+// Velocity (incremental) form: every update adds the sum of the component increments to the previous,
+// clamped output. The integral action lives in the output itself, so it cannot wind up past the limits.
+template<
+  typename T,
+  Component<T> ProportionalT,
+  Component<T> IntegralT,
+  Component<T> DerivativeT,
+  typename LimitsT = Limits<T>>
+class VelocityPID
+{
+public:
+  using value_type = T;
+
+  constexpr VelocityPID(ProportionalT proportional, IntegralT integral, DerivativeT derivative, T min, T max)
+    requires std::constructible_from<LimitsT, T, T>
+    : proportional(proportional)
+    , integral(integral)
+    , derivative(derivative)
+    , limits(min, max)
+    , pre_output(std::clamp(T(0), min, max))
+  {
+  }
+
+  constexpr T calculate(T setpoint, T pv)
+  {
+    const T delta = proportional.calculate(setpoint, pv) + integral.calculate(setpoint, pv) +
+                    derivative.calculate(setpoint, pv);
+    pre_output    = std::clamp(pre_output + delta, limits.min(), limits.max());
+    return pre_output;
+  }
+
+  constexpr T calculate(T setpoint, T pv, T dt)
+    requires VariableStep<ProportionalT> && VariableStep<IntegralT> && VariableStep<DerivativeT>
+  {
+    const T delta = proportional.calculate(setpoint, pv, dt) + integral.calculate(setpoint, pv, dt) +
+                    derivative.calculate(setpoint, pv, dt);
+    pre_output    = std::clamp(pre_output + delta, limits.min(), limits.max());
+    return pre_output;
+  }
+
+  // Continues from output on the next update, e.g. the manual value when switching to automatic.
+  constexpr void track(T output) { pre_output = std::clamp(output, limits.min(), limits.max()); }
+
+  constexpr T output() const { return pre_output; }
+  constexpr T min() const { return limits.min(); }
+  constexpr T max() const { return limits.max(); }
+
+  // The increments are summed by the output, which adds the pole at z = 1.
+  constexpr Response<T> response(std::complex<T> z) const
+    requires std::floating_point<T>
+  {
+    const auto p   = proportional.response(z);
+    const auto i   = integral.response(z);
+    const auto d   = derivative.response(z);
+    const auto sum = z / (z - T(1));
+    return { sum * (p.setpoint + i.setpoint + d.setpoint), sum * (p.feedback + i.feedback + d.feedback) };
   }
 
-  void setKp(T kp)
+  constexpr void setKp(T kp)
     requires CoeffMutable<ProportionalT>
   {
     proportional.set(kp);
   }
 
-  void setKi(T ki)
+  constexpr void setKi(T ki)
     requires CoeffMutable<IntegralT>
   {
     integral.set(ki);
   }
 
-  void setKd(T kd)
+  constexpr void setKd(T kd)
     requires CoeffMutable<DerivativeT>
   {
     derivative.set(kd);
   }
 
+  constexpr void setGains(const Gains<T>& gains)
+    requires CoeffMutable<ProportionalT> && CoeffMutable<IntegralT> && CoeffMutable<DerivativeT>
+  {
+    proportional.set(gains.kp);
+    integral.set(gains.ki);
+    derivative.set(gains.kd);
+  }
+
 private:
-  ProportionalT proportional;
-  IntegralT     integral;
-  DerivativeT   derivative;
-  const T       min;
-  const T       max;
+  [[no_unique_address]] ProportionalT proportional;
+  [[no_unique_address]] IntegralT     integral;
+  [[no_unique_address]] DerivativeT   derivative;
+  [[no_unique_address]] LimitsT       limits;
+  T                                   pre_output;
 };
 
 template<typename T>
-auto
+constexpr auto
 pi(T kp, T ki, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
 {
   return PID<T, Proportional<T>, Integral<T>, Zero<T>>(
@@ -199,8 +1319,17 @@ pi(T kp, T ki, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::nume
   );
 }
 
+template<template<typename> typename IntegralT, typename T>
+constexpr auto
+pi(T kp, T ki, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
+{
+  return PID<T, Proportional<T>, IntegralT<T>, Zero<T>>(
+    Proportional<T>(kp, sp), IntegralT<T>(ki, sp, min, max), Zero<T>(), min, max
+  );
+}
+
 template<typename T>
-auto
+constexpr auto
 pd(T kp, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
 {
   return PID<T, Proportional<T>, Zero<T>, Derivative<T>>(
@@ -209,7 +1338,7 @@ pd(T kp, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::nume
 }
 
 template<typename T>
-auto
+constexpr auto
 pid(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
 {
   return PID<T, Proportional<T>, Integral<T>, Derivative<T>>(
@@ -217,8 +1346,17 @@ pid(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = st
   );
 }
 
+template<template<typename> typename IntegralT, typename T>
+constexpr auto
+pid(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
+{
+  return PID<T, Proportional<T>, IntegralT<T>, Derivative<T>>(
+    Proportional<T>(kp, sp), IntegralT<T>(ki, sp, min, max), Derivative<T>(kd, sp), min, max
+  );
+}
+
 template<typename T>
-auto
+constexpr auto
 pi_d(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
 {
   return PID<T, Proportional<T>, Integral<T>, PrecedingDerivative<T>>(
@@ -226,8 +1364,17 @@ pi_d(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = s
   );
 }
 
+template<template<typename> typename IntegralT, typename T>
+constexpr auto
+pi_d(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
+{
+  return PID<T, Proportional<T>, IntegralT<T>, PrecedingDerivative<T>>(
+    Proportional<T>(kp, sp), IntegralT<T>(ki, sp, min, max), PrecedingDerivative<T>(kd, sp), min, max
+  );
+}
+
 template<typename T>
-auto
+constexpr auto
 i_pd(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
 {
   return PID<T, PrecedingProportional<T>, Integral<T>, PrecedingDerivative<T>>(
@@ -235,6 +1382,247 @@ i_pd(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = s
   );
 }
 
+template<template<typename> typename IntegralT, typename T>
+constexpr auto
+i_pd(T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
+{
+  return PID<T, PrecedingProportional<T>, IntegralT<T>, PrecedingDerivative<T>>(
+    PrecedingProportional<T>(kp, sp), IntegralT<T>(ki, sp, min, max), PrecedingDerivative<T>(kd, sp), min, max
+  );
+}
+
+// Two-degree-of-freedom PID with setpoint weights b on the P term and c on the D term.
+template<typename T>
+constexpr auto
+pid_2dof(
+  T kp,
+  T ki,
+  T kd,
+  T b,
+  T c,
+  T sp,
+  T min = std::numeric_limits<T>::lowest(),
+  T max = std::numeric_limits<T>::max()
+)
+{
+  return PID<T, WeightedProportional<T>, Integral<T>, WeightedDerivative<T>>(
+    WeightedProportional<T>(kp, sp, b),
+    Integral<T>(ki, sp, min, max),
+    WeightedDerivative<T>(kd, sp, c),
+    min,
+    max
+  );
+}
+
+// Controllers with a low-pass filtered derivative term, see FilteredDerivative for n.
+template<typename T>
+constexpr auto
+pid_filtered(
+  T kp, T ki, T kd, T n, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()
+)
+{
+  return PID<T, Proportional<T>, Integral<T>, FilteredDerivative<T>>(
+    Proportional<T>(kp, sp), Integral<T>(ki, sp, min, max), FilteredDerivative<T>(kd, sp, kp, n), min, max
+  );
+}
+
+template<typename T>
+constexpr auto
+pi_d_filtered(
+  T kp, T ki, T kd, T n, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()
+)
+{
+  return PID<T, Proportional<T>, Integral<T>, PrecedingFilteredDerivative<T>>(
+    Proportional<T>(kp, sp),
+    Integral<T>(ki, sp, min, max),
+    PrecedingFilteredDerivative<T>(kd, sp, kp, n),
+    min,
+    max
+  );
+}
+
+template<typename T>
+constexpr auto
+i_pd_filtered(
+  T kp, T ki, T kd, T n, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()
+)
+{
+  return PID<T, PrecedingProportional<T>, Integral<T>, PrecedingFilteredDerivative<T>>(
+    PrecedingProportional<T>(kp, sp),
+    Integral<T>(ki, sp, min, max),
+    PrecedingFilteredDerivative<T>(kd, sp, kp, n),
+    min,
+    max
+  );
+}
+
+template<typename T>
+constexpr auto
+velocity_pi(T kp, T ki, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
+{
+  return VelocityPID<T, VelocityProportional<T>, VelocityIntegral<T>, Zero<T>>(
+    VelocityProportional<T>(kp, sp), VelocityIntegral<T>(ki, sp), Zero<T>(), min, max
+  );
+}
+
+template<typename T>
+constexpr auto
+velocity_pd(T kp, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
+{
+  return VelocityPID<T, VelocityProportional<T>, Zero<T>, VelocityDerivative<T>>(
+    VelocityProportional<T>(kp, sp), Zero<T>(), VelocityDerivative<T>(kd, sp), min, max
+  );
+}
+
+template<typename T>
+constexpr auto
+velocity_pid(
+  T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()
+)
+{
+  return VelocityPID<T, VelocityProportional<T>, VelocityIntegral<T>, VelocityDerivative<T>>(
+    VelocityProportional<T>(kp, sp), VelocityIntegral<T>(ki, sp), VelocityDerivative<T>(kd, sp), min, max
+  );
+}
+
+template<typename T>
+constexpr auto
+velocity_pi_d(
+  T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()
+)
+{
+  return VelocityPID<T, VelocityProportional<T>, VelocityIntegral<T>, VelocityPrecedingDerivative<T>>(
+    VelocityProportional<T>(kp, sp),
+    VelocityIntegral<T>(ki, sp),
+    VelocityPrecedingDerivative<T>(kd, sp),
+    min,
+    max
+  );
+}
+
+template<typename T>
+constexpr auto
+velocity_i_pd(
+  T kp, T ki, T kd, T sp, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()
+)
+{
+  using P = VelocityPrecedingProportional<T>;
+  using I = VelocityIntegral<T>;
+  using D = VelocityPrecedingDerivative<T>;
+  return VelocityPID<T, P, I, D>(P(kp, sp), I(ki, sp), D(kd, sp), min, max);
+}
+
+namespace detail {
+
+// Terms with a zero gain are replaced by Zero. An integral term is only dropped when its clamp would
+// leave a zero accumulator unchanged.
+template<typename T, T kp, template<typename U, U> typename ComponentT>
+using static_proportional_t = std::conditional_t<kp == T(0), Zero<T>, ComponentT<T, kp>>;
+
+template<typename T, T ki, T dt, T minv, T maxv>
+using static_integral_t = std::conditional_t<
+  ki == T(0) && minv <= T(0) && T(0) <= maxv,
+  Zero<T>,
+  StaticIntegral<T, ki, dt, minv, maxv>>;
+
+template<typename T, T kd, T dt, template<typename U, U, U> typename ComponentT>
+using static_derivative_t = std::conditional_t<kd == T(0), Zero<T>, ComponentT<T, kd, dt>>;
+
+} // namespace detail
+
+template<
+  auto kp,
+  auto ki,
+  auto sp,
+  auto min = std::numeric_limits<decltype(kp)>::lowest(),
+  auto max = std::numeric_limits<decltype(kp)>::max()>
+constexpr auto
+pi()
+{
+  using T = decltype(kp);
+  return PID<
+    T,
+    detail::static_proportional_t<T, kp, StaticProportional>,
+    detail::static_integral_t<T, T(ki), T(sp), T(min), T(max)>,
+    Zero<T>,
+    StaticLimits<T, T(min), T(max)>>({}, {}, {});
+}
+
+template<
+  auto kp,
+  auto kd,
+  auto sp,
+  auto min = std::numeric_limits<decltype(kp)>::lowest(),
+  auto max = std::numeric_limits<decltype(kp)>::max()>
+constexpr auto
+pd()
+{
+  using T = decltype(kp);
+  return PID<
+    T,
+    detail::static_proportional_t<T, kp, StaticProportional>,
+    Zero<T>,
+    detail::static_derivative_t<T, T(kd), T(sp), StaticDerivative>,
+    StaticLimits<T, T(min), T(max)>>({}, {}, {});
+}
+
+template<
+  auto kp,
+  auto ki,
+  auto kd,
+  auto sp,
+  auto min = std::numeric_limits<decltype(kp)>::lowest(),
+  auto max = std::numeric_limits<decltype(kp)>::max()>
+constexpr auto
+pid()
+{
+  using T = decltype(kp);
+  return PID<
+    T,
+    detail::static_proportional_t<T, kp, StaticProportional>,
+    detail::static_integral_t<T, T(ki), T(sp), T(min), T(max)>,
+    detail::static_derivative_t<T, T(kd), T(sp), StaticDerivative>,
+    StaticLimits<T, T(min), T(max)>>({}, {}, {});
+}
+
+template<
+  auto kp,
+  auto ki,
+  auto kd,
+  auto sp,
+  auto min = std::numeric_limits<decltype(kp)>::lowest(),
+  auto max = std::numeric_limits<decltype(kp)>::max()>
+constexpr auto
+pi_d()
+{
+  using T = decltype(kp);
+  return PID<
+    T,
+    detail::static_proportional_t<T, kp, StaticProportional>,
+    detail::static_integral_t<T, T(ki), T(sp), T(min), T(max)>,
+    detail::static_derivative_t<T, T(kd), T(sp), StaticPrecedingDerivative>,
+    StaticLimits<T, T(min), T(max)>>({}, {}, {});
+}
+
+template<
+  auto kp,
+  auto ki,
+  auto kd,
+  auto sp,
+  auto min = std::numeric_limits<decltype(kp)>::lowest(),
+  auto max = std::numeric_limits<decltype(kp)>::max()>
+constexpr auto
+i_pd()
+{
+  using T = decltype(kp);
+  return PID<
+    T,
+    detail::static_proportional_t<T, kp, StaticPrecedingProportional>,
+    detail::static_integral_t<T, T(ki), T(sp), T(min), T(max)>,
+    detail::static_derivative_t<T, T(kd), T(sp), StaticPrecedingDerivative>,
+    StaticLimits<T, T(min), T(max)>>({}, {}, {});
+}
+
 } // namespace mamePID
 
 #endif // MAMEPID_HPP_
\ No newline at end of file
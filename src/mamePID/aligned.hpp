@@ -0,0 +1,43 @@
+#ifndef MAMEPID_ALIGNED_HPP_
+#define MAMEPID_ALIGNED_HPP_
+
+#include <cstddef>
+#include <new>
+
+namespace mamePID {
+
+namespace detail {
+
+// Fixed instead of std::hardware_destructive_interference_size, whose value may differ between
+// translation units compiled with different flags.
+inline constexpr std::size_t cache_line = 64;
+
+// Allocates whole cache lines, so two vectors never share one.
+template<typename T>
+struct CacheAlignedAllocator
+{
+  using value_type = T;
+
+  CacheAlignedAllocator() = default;
+
+  template<typename U>
+  CacheAlignedAllocator(const CacheAlignedAllocator<U>&)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    const std::size_t bytes = (n * sizeof(T) + cache_line - 1) / cache_line * cache_line;
+    return static_cast<T*>(::operator new(bytes, std::align_val_t(cache_line)));
+  }
+
+  void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t(cache_line)); }
+
+  friend bool operator==(const CacheAlignedAllocator&, const CacheAlignedAllocator&) { return true; }
+};
+
+} // namespace detail
+
+} // namespace mamePID
+
+#endif // MAMEPID_ALIGNED_HPP_
@@ -0,0 +1,143 @@
+#ifndef MAMEPID_ANY_HPP_
+#define MAMEPID_ANY_HPP_
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <mamePID.hpp>
+
+namespace mamePID {
+
+template<typename C, typename T>
+concept ErasableController = std::copy_constructible<C> && requires(C c, T v) {
+  { c.calculate(v, v) } -> std::convertible_to<T>;
+};
+
+// Type-erased controller stored inline in a Capacity-byte buffer, dispatched through a static table of
+// function pointers. Never allocates; a controller that does not fit, or whose move constructor may throw,
+// is rejected at compile time.
+template<typename T, std::size_t Capacity = 128>
+class AnyController
+{
+public:
+  using value_type = T;
+
+  AnyController() {}
+
+  template<typename C>
+    requires(!std::same_as<std::remove_cvref_t<C>, AnyController> &&
+             ErasableController<std::remove_cvref_t<C>, T>)
+  AnyController(C&& controller)
+  {
+    using D = std::remove_cvref_t<C>;
+    static_assert(sizeof(D) <= Capacity, "controller does not fit into AnyController; raise Capacity");
+    static_assert(alignof(D) <= alignof(std::max_align_t), "controller is over-aligned for AnyController");
+    static_assert(std::is_nothrow_move_constructible_v<D>, "AnyController moves are noexcept");
+    ::new (static_cast<void*>(buffer)) D(std::forward<C>(controller));
+    vtable = &vtable_for<D>;
+  }
+
+  AnyController(const AnyController& other)
+  {
+    if (other.vtable) {
+      other.vtable->copy(buffer, other.buffer);
+      vtable = other.vtable;
+    }
+  }
+
+  AnyController(AnyController&& other) noexcept
+  {
+    if (other.vtable) {
+      other.vtable->move(buffer, other.buffer);
+      vtable       = other.vtable;
+      other.vtable = nullptr;
+    }
+  }
+
+  AnyController& operator=(const AnyController& other)
+  {
+    if (this != &other) {
+      reset();
+      if (other.vtable) {
+        other.vtable->copy(buffer, other.buffer);
+        vtable = other.vtable;
+      }
+    }
+    return *this;
+  }
+
+  AnyController& operator=(AnyController&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      if (other.vtable) {
+        other.vtable->move(buffer, other.buffer);
+        vtable       = other.vtable;
+        other.vtable = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  ~AnyController() { reset(); }
+
+  T calculate(T setpoint, T pv)
+  {
+    assert(vtable);
+    return vtable->calculate(buffer, setpoint, pv);
+  }
+
+  explicit operator bool() const { return vtable != nullptr; }
+
+  void reset()
+  {
+    if (vtable) {
+      vtable->destroy(buffer);
+      vtable = nullptr;
+    }
+  }
+
+  // The stored controller if it is a C, otherwise nullptr.
+  template<typename C>
+  C* target()
+  {
+    return vtable == &vtable_for<C> ? std::launder(reinterpret_cast<C*>(buffer)) : nullptr;
+  }
+
+  template<typename C>
+  const C* target() const
+  {
+    return vtable == &vtable_for<C> ? std::launder(reinterpret_cast<const C*>(buffer)) : nullptr;
+  }
+
+private:
+  struct VTable
+  {
+    T (*calculate)(void*, T, T);
+    void (*copy)(void*, const void*);
+    void (*move)(void*, void*);
+    void (*destroy)(void*);
+  };
+
+  template<typename C>
+  static constexpr VTable vtable_for{
+    [](void* self, T setpoint, T pv) -> T { return static_cast<C*>(self)->calculate(setpoint, pv); },
+    [](void* dst, const void* src) { ::new (dst) C(*static_cast<const C*>(src)); },
+    [](void* dst, void* src) {
+      ::new (dst) C(std::move(*static_cast<C*>(src)));
+      static_cast<C*>(src)->~C();
+    },
+    [](void* self) { static_cast<C*>(self)->~C(); },
+  };
+
+  const VTable* vtable = nullptr;
+  alignas(std::max_align_t) std::byte buffer[Capacity];
+};
+
+} // namespace mamePID
+
+#endif // MAMEPID_ANY_HPP_
@@ -0,0 +1,317 @@
+#ifndef MAMEPID_ASYNC_HPP_
+#define MAMEPID_ASYNC_HPP_
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <mamePID.hpp>
+
+namespace mamePID {
+
+class Executor;
+
+namespace detail {
+
+// The part of a Mailbox its executor detaches on teardown: the waiting reader and whether it has been
+// posted but not resumed yet.
+struct MailboxBase
+{
+  Executor*               executor;
+  std::coroutine_handle<> reader{};
+  bool                    woken = false;
+};
+
+} // namespace detail
+
+// Coroutine started and owned by an Executor. It does not run until passed to Executor::spawn(), and its
+// frame is freed when it finishes.
+class Task
+{
+public:
+  struct promise_type
+  {
+    Executor*          executor = nullptr;
+    std::size_t        index    = 0;
+    std::exception_ptr error;
+
+    Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct Finish
+    {
+      bool await_ready() noexcept { return false; }
+      void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+      void await_resume() noexcept {}
+    };
+
+    Finish final_suspend() noexcept { return {}; }
+    void   return_void() {}
+    void   unhandled_exception() { error = std::current_exception(); }
+  };
+
+  Task(Task&& other) noexcept
+    : handle(std::exchange(other.handle, {}))
+  {
+  }
+
+  Task& operator=(Task&& other) noexcept
+  {
+    if (this != &other) {
+      if (handle) {
+        handle.destroy();
+      }
+      handle = std::exchange(other.handle, {});
+    }
+    return *this;
+  }
+
+  ~Task()
+  {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+private:
+  friend class Executor;
+
+  explicit Task(std::coroutine_handle<promise_type> handle)
+    : handle(handle)
+  {
+  }
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+// Single-threaded run queue. Coroutines are resumed in the order they were posted, only from run() or
+// run_one(), so nothing they share needs to be synchronized. post() must be called from the thread that
+// runs the executor.
+class Executor
+{
+public:
+  Executor() = default;
+
+  Executor(const Executor&)            = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  ~Executor()
+  {
+    // Tasks that never finished are still suspended somewhere; their frames are freed here. Mailboxes
+    // forget their readers first, so a later push() neither posts to this executor nor resumes a freed
+    // frame.
+    for (auto* mailbox : mailboxes) {
+      mailbox->executor = nullptr;
+      mailbox->reader   = {};
+      mailbox->woken    = false;
+    }
+    for (auto handle : tasks) {
+      handle.destroy();
+    }
+  }
+
+  // Takes ownership of task and queues its start.
+  void spawn(Task task)
+  {
+    auto handle               = std::exchange(task.handle, {});
+    handle.promise().executor = this;
+    handle.promise().index    = tasks.size();
+    tasks.push_back(handle);
+    post(handle);
+  }
+
+  void post(std::coroutine_handle<> handle) { queue.push_back(handle); }
+
+  // Resumes queued coroutines, including those queued meanwhile, until the queue is empty. Returns the
+  // number of coroutines resumed. An exception that escaped a task is rethrown after that task is freed.
+  std::size_t run()
+  {
+    std::size_t resumed = 0;
+    while (!queue.empty()) {
+      ready.swap(queue);
+      for (std::size_t i = 0; i < ready.size(); ++i) {
+        ready[i].resume();
+        ++resumed;
+        if (error) {
+          queue.insert(queue.begin(), ready.begin() + i + 1, ready.end());
+          ready.clear();
+          rethrow();
+        }
+      }
+      ready.clear();
+    }
+    return resumed;
+  }
+
+  // Resumes the oldest queued coroutine, if any.
+  bool run_one()
+  {
+    if (queue.empty()) {
+      return false;
+    }
+    const auto handle = queue.front();
+    queue.pop_front();
+    handle.resume();
+    rethrow();
+    return true;
+  }
+
+  // Number of spawned tasks that have not finished.
+  std::size_t active() const { return tasks.size(); }
+
+  // Number of coroutines waiting to be resumed.
+  std::size_t pending() const { return queue.size(); }
+
+private:
+  friend struct Task::promise_type::Finish;
+
+  template<typename T>
+  friend class Mailbox;
+
+  void attach(detail::MailboxBase* mailbox) { mailboxes.push_back(mailbox); }
+
+  void detach(detail::MailboxBase* mailbox) { std::erase(mailboxes, mailbox); }
+
+  void finish(std::coroutine_handle<Task::promise_type> handle)
+  {
+    auto& promise = handle.promise();
+    if (promise.error && !error) {
+      error = promise.error;
+    }
+    const std::size_t index      = promise.index;
+    tasks[index]                 = tasks.back();
+    tasks[index].promise().index = index;
+    tasks.pop_back();
+    handle.destroy();
+  }
+
+  void rethrow()
+  {
+    if (error) {
+      std::rethrow_exception(std::exchange(error, {}));
+    }
+  }
+
+  std::deque<std::coroutine_handle<>>                    queue;
+  std::deque<std::coroutine_handle<>>                    ready;
+  std::vector<std::coroutine_handle<Task::promise_type>> tasks;
+  std::vector<detail::MailboxBase*>                      mailboxes;
+  std::exception_ptr                                     error;
+};
+
+inline void
+Task::promise_type::Finish::await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+{
+  handle.promise().executor->finish(handle);
+}
+
+// Single-slot channel between callback-style IO and a coroutine. The IO side calls push() when a value
+// arrives, e.g. from the completion handler of a sensor read; a coroutine awaits read(), which completes
+// at once if a value is waiting and otherwise resumes through the executor after the next push(). A value
+// that is not read before the next push() is replaced by it, so a slow reader always sees the latest one.
+// Only one coroutine may wait at a time. Once a push() has posted the waiting reader, the value is kept
+// for it: try_read() returns nothing until the reader has resumed. If the executor is destroyed first,
+// the mailbox keeps working as a plain slot.
+template<typename T>
+class Mailbox : private detail::MailboxBase
+{
+public:
+  explicit Mailbox(Executor& executor)
+    : MailboxBase{ &executor }
+  {
+    executor.attach(this);
+  }
+
+  Mailbox(const Mailbox&)            = delete;
+  Mailbox& operator=(const Mailbox&) = delete;
+
+  ~Mailbox()
+  {
+    if (executor) {
+      executor->detach(this);
+    }
+  }
+
+  void push(T value)
+  {
+    slot = std::move(value);
+    if (reader) {
+      woken = true;
+      executor->post(std::exchange(reader, {}));
+    }
+  }
+
+  std::optional<T> try_read()
+  {
+    if (woken) {
+      return std::nullopt;
+    }
+    return std::exchange(slot, std::nullopt);
+  }
+
+  auto read()
+  {
+    struct Awaiter
+    {
+      Mailbox& mailbox;
+
+      bool await_ready() const noexcept { return mailbox.slot.has_value() && !mailbox.woken; }
+
+      void await_suspend(std::coroutine_handle<> handle) noexcept
+      {
+        assert(!mailbox.reader);
+        mailbox.reader = handle;
+      }
+
+      T await_resume()
+      {
+        mailbox.woken = false;
+        assert(mailbox.slot.has_value());
+        return *std::exchange(mailbox.slot, std::nullopt);
+      }
+    };
+    return Awaiter{ *this };
+  }
+
+  // As a sink: the value is handed over without waiting.
+  std::suspend_never write(T value)
+  {
+    push(std::move(value));
+    return {};
+  }
+
+private:
+  std::optional<T> slot;
+};
+
+// Closed loop between an awaitable sensor and an awaitable actuator: steps times, pv = co_await
+// sensor.read(), then co_await actuator.write(controller.calculate(setpoint, pv)). setpoint is read on
+// every step, so it can be changed while the loop runs. controller, sensor, actuator and setpoint are
+// referenced, not copied, and must outlive the task.
+template<typename ControllerT, typename Sensor, typename Actuator>
+  requires Component<ControllerT, typename ControllerT::value_type>
+Task
+drive(
+  ControllerT&                            controller,
+  Sensor&                                 sensor,
+  Actuator&                               actuator,
+  const typename ControllerT::value_type& setpoint,
+  std::size_t                             steps = std::numeric_limits<std::size_t>::max()
+)
+{
+  for (std::size_t k = 0; k < steps; ++k) {
+    const typename ControllerT::value_type pv = co_await sensor.read();
+    co_await actuator.write(controller.calculate(setpoint, pv));
+  }
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_ASYNC_HPP_
@@ -0,0 +1,270 @@
+#ifndef MAMEPID_BANK_HPP_
+#define MAMEPID_BANK_HPP_
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/simd.hpp>
+
+namespace mamePID {
+
+template<typename T, typename ProportionalT, typename IntegralT, typename DerivativeT>
+concept BankComposition =
+  ((std::is_same_v<ProportionalT, Proportional<T>> ||
+    std::is_same_v<ProportionalT, PrecedingProportional<T>>) &&
+   (std::is_same_v<IntegralT, Integral<T>> || std::is_same_v<IntegralT, Zero<T>>) &&
+   (std::is_same_v<DerivativeT, Derivative<T>> || std::is_same_v<DerivativeT, PrecedingDerivative<T>> ||
+    std::is_same_v<DerivativeT, Zero<T>>)) ||
+  (std::is_same_v<ProportionalT, WeightedProportional<T>> &&
+   (std::is_same_v<IntegralT, Integral<T>> || std::is_same_v<IntegralT, Zero<T>>) &&
+   (std::is_same_v<DerivativeT, WeightedDerivative<T>> || std::is_same_v<DerivativeT, Zero<T>>)) ||
+  (std::floating_point<T> &&
+   (std::is_same_v<ProportionalT, Proportional<T>> ||
+    std::is_same_v<ProportionalT, PrecedingProportional<T>>) &&
+   (std::is_same_v<IntegralT, Integral<T>> || std::is_same_v<IntegralT, Zero<T>>) &&
+   (std::is_same_v<DerivativeT, FilteredDerivative<T>> ||
+    std::is_same_v<DerivativeT, PrecedingFilteredDerivative<T>>));
+
+// Structure-of-arrays counterpart of PID<T, ProportionalT, IntegralT, DerivativeT>.
+// Every loop in the bank shares the composition but has its own gains, limits and state. Weighted banks
+// also give every loop its own setpoint weights, so PID, PI-D and I-PD loops can share one kernel.
+// Filtered banks give every loop its own derivative filter coefficient n, unfiltered until set_filter().
+template<typename T, Component<T> ProportionalT, Component<T> IntegralT, Component<T> DerivativeT>
+  requires BankComposition<T, ProportionalT, IntegralT, DerivativeT>
+class PIDBank
+{
+public:
+  using value_type = T;
+
+  static constexpr bool preceding_proportional = std::is_same_v<ProportionalT, PrecedingProportional<T>>;
+  static constexpr bool has_integral           = std::is_same_v<IntegralT, Integral<T>>;
+  static constexpr bool has_derivative         = !std::is_same_v<DerivativeT, Zero<T>>;
+  static constexpr bool preceding_derivative   = std::is_same_v<DerivativeT, PrecedingDerivative<T>> ||
+                                               std::is_same_v<DerivativeT, PrecedingFilteredDerivative<T>>;
+  static constexpr bool weighted               = std::is_same_v<ProportionalT, WeightedProportional<T>>;
+  static constexpr bool filtered               = std::is_same_v<DerivativeT, FilteredDerivative<T>> ||
+                                   std::is_same_v<DerivativeT, PrecedingFilteredDerivative<T>>;
+
+  PIDBank() {}
+
+  explicit PIDBank(std::size_t capacity) { reserve(capacity); }
+
+  std::size_t push_back(
+    const Gains<T>& gains,
+    T               sp,
+    T               min = std::numeric_limits<T>::lowest(),
+    T               max = std::numeric_limits<T>::max()
+  )
+  {
+    kp.push_back(gains.kp);
+    dt.push_back(sp);
+    if constexpr (has_integral) {
+      ki.push_back(accumulator_t<T>(gains.ki) * accumulator_t<T>(sp));
+      integral.push_back(accumulator_t<T>{});
+    }
+    if constexpr (has_derivative) {
+      kd.push_back(gains.kd / sp);
+      pre.push_back(T{});
+    }
+    minv.push_back(min);
+    maxv.push_back(max);
+    if constexpr (weighted) {
+      b.push_back(T(1));
+      c.push_back(T(1));
+    }
+    if constexpr (filtered) {
+      raw_kd.push_back(gains.kd);
+      n.push_back(std::numeric_limits<T>::infinity());
+      a.push_back(T(0));
+      derivative.push_back(T(0));
+      update_filter(kp.size() - 1);
+    }
+    return kp.size() - 1;
+  }
+
+  std::size_t push_back(
+    const Gains<T>&   gains,
+    const Weights<T>& weights,
+    T                 sp,
+    T                 min = std::numeric_limits<T>::lowest(),
+    T                 max = std::numeric_limits<T>::max()
+  )
+    requires weighted
+  {
+    const std::size_t index = push_back(gains, sp, min, max);
+    set_weights(index, weights);
+    return index;
+  }
+
+  void reserve(std::size_t capacity)
+  {
+    kp.reserve(capacity);
+    dt.reserve(capacity);
+    if constexpr (has_integral) {
+      ki.reserve(capacity);
+      integral.reserve(capacity);
+    }
+    if constexpr (has_derivative) {
+      kd.reserve(capacity);
+      pre.reserve(capacity);
+    }
+    minv.reserve(capacity);
+    maxv.reserve(capacity);
+    if constexpr (weighted) {
+      b.reserve(capacity);
+      c.reserve(capacity);
+    }
+    if constexpr (filtered) {
+      raw_kd.reserve(capacity);
+      n.reserve(capacity);
+      a.reserve(capacity);
+      derivative.reserve(capacity);
+    }
+  }
+
+  std::size_t size() const { return kp.size(); }
+
+  void set_gains(std::size_t index, const Gains<T>& gains)
+  {
+    assert(index < size());
+    kp[index] = gains.kp;
+    if constexpr (has_integral) {
+      ki[index] = accumulator_t<T>(gains.ki) * accumulator_t<T>(dt[index]);
+    }
+    if constexpr (filtered) {
+      raw_kd[index] = gains.kd;
+      update_filter(index);
+    } else if constexpr (has_derivative) {
+      kd[index] = gains.kd / dt[index];
+    }
+  }
+
+  // Filter coefficient of the derivative, as in FilteredDerivative.
+  void set_filter(std::size_t index, T n)
+    requires filtered
+  {
+    assert(index < size());
+    this->n[index] = n;
+    update_filter(index);
+  }
+
+  void set_weights(std::size_t index, const Weights<T>& weights)
+    requires weighted
+  {
+    assert(index < size());
+    b[index] = weights.b;
+    c[index] = weights.c;
+  }
+
+  void calculate(std::span<const T> setpoints, std::span<const T> pvs, std::span<T> out)
+  {
+    calculate(setpoints, pvs, out, simd::best());
+  }
+
+  void calculate(std::span<const T> setpoints, std::span<const T> pvs, std::span<T> out, simd::Isa isa)
+  {
+    assert(setpoints.size() == size() && pvs.size() == size() && out.size() == size());
+
+    const simd::Lanes<T> lanes{ kp.data(),  ki.data(), kd.data(), minv.data(), maxv.data(), integral.data(),
+                                pre.data(), b.data(),  c.data(),  a.data(),    derivative.data() };
+    simd::step<preceding_proportional, has_integral, has_derivative, preceding_derivative, weighted,
+               filtered>(isa, lanes, setpoints.data(), pvs.data(), out.data(), size());
+  }
+
+private:
+  // Same coefficients as FilteredDerivative, with kd holding its b.
+  void update_filter(std::size_t index)
+  {
+    const T tf = kp[index] == T(0) ? T(0) : raw_kd[index] / (kp[index] * n[index]);
+    a[index]   = tf / (tf + dt[index]);
+    kd[index]  = raw_kd[index] / (tf + dt[index]);
+  }
+
+  std::vector<T>                kp;
+  std::vector<accumulator_t<T>> ki;
+  std::vector<T>                kd;
+  std::vector<T>                minv;
+  std::vector<T>                maxv;
+  std::vector<T>                dt;
+  std::vector<accumulator_t<T>> integral;
+  std::vector<T>                pre;
+  std::vector<T>                b;
+  std::vector<T>                c;
+  std::vector<T>                raw_kd;
+  std::vector<T>                n;
+  std::vector<T>                a;
+  std::vector<T>                derivative;
+};
+
+template<typename T>
+auto
+pi_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, Proportional<T>, Integral<T>, Zero<T>>(capacity);
+}
+
+template<typename T>
+auto
+pd_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, Proportional<T>, Zero<T>, Derivative<T>>(capacity);
+}
+
+template<typename T>
+auto
+pid_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, Proportional<T>, Integral<T>, Derivative<T>>(capacity);
+}
+
+template<typename T>
+auto
+pi_d_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, Proportional<T>, Integral<T>, PrecedingDerivative<T>>(capacity);
+}
+
+template<typename T>
+auto
+i_pd_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, PrecedingProportional<T>, Integral<T>, PrecedingDerivative<T>>(capacity);
+}
+
+template<typename T>
+auto
+pid_2dof_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, WeightedProportional<T>, Integral<T>, WeightedDerivative<T>>(capacity);
+}
+
+template<std::floating_point T>
+auto
+pid_filtered_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, Proportional<T>, Integral<T>, FilteredDerivative<T>>(capacity);
+}
+
+template<std::floating_point T>
+auto
+pi_d_filtered_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, Proportional<T>, Integral<T>, PrecedingFilteredDerivative<T>>(capacity);
+}
+
+template<std::floating_point T>
+auto
+i_pd_filtered_bank(std::size_t capacity = 0)
+{
+  return PIDBank<T, PrecedingProportional<T>, Integral<T>, PrecedingFilteredDerivative<T>>(capacity);
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_BANK_HPP_
@@ -0,0 +1,174 @@
+#ifndef MAMEPID_CASCADE_HPP_
+#define MAMEPID_CASCADE_HPP_
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/bank.hpp>
+
+namespace mamePID {
+
+template<typename C>
+concept CascadeLoop = requires(C c, typename C::value_type v) {
+  { c.calculate(v, v) } -> std::convertible_to<typename C::value_type>;
+};
+
+// Two loops in series: the output of the outer loop is the setpoint of the inner loop, e.g. a position
+// loop driving a velocity loop. The inner loop is stepped on every call and the outer loop on every
+// ratio-th call, starting with the first, so the outer controller must be built with ratio times the
+// sampling period of the inner one. Between outer updates the inner setpoint is held.
+// A cascade takes two process values per step, so it is not a Component: it cannot be put in a Scheduler,
+// RateScheduler or AnyController, nor driven by drive(). Add its two loops to those separately, or step the
+// cascade from a loop of its own; CascadeBank covers many axes.
+template<CascadeLoop OuterT, CascadeLoop InnerT>
+  requires std::same_as<typename OuterT::value_type, typename InnerT::value_type>
+class Cascade
+{
+public:
+  using value_type = typename InnerT::value_type;
+
+  constexpr Cascade(OuterT outer, InnerT inner, std::uint32_t ratio = 1)
+    : outer_loop(std::move(outer))
+    , inner_loop(std::move(inner))
+    , period(ratio)
+  {
+    assert(0 < ratio);
+  }
+
+  // outer_pv is only read on the calls that step the outer loop.
+  constexpr value_type calculate(value_type setpoint, value_type outer_pv, value_type inner_pv)
+  {
+    if (phase == 0) {
+      inner_sp = outer_loop.calculate(setpoint, outer_pv);
+      phase    = period;
+    }
+    --phase;
+    return inner_loop.calculate(inner_sp, inner_pv);
+  }
+
+  // Steps the cascade once per sample: out[k] = calculate(setpoints[k], outer_pvs[k], inner_pvs[k]).
+  // Both loops are copied to a local for the whole span, so their state stays in registers instead of
+  // being reloaded after every store to out.
+  constexpr void run(
+    std::span<const value_type> setpoints,
+    std::span<const value_type> outer_pvs,
+    std::span<const value_type> inner_pvs,
+    std::span<value_type>       out
+  )
+  {
+    assert(setpoints.size() == out.size() && outer_pvs.size() == out.size());
+    assert(inner_pvs.size() == out.size());
+
+    Cascade cascade = *this;
+    for (std::size_t k = 0; k < out.size(); ++k) {
+      out[k] = cascade.calculate(setpoints[k], outer_pvs[k], inner_pvs[k]);
+    }
+    *this = cascade;
+  }
+
+  constexpr value_type min() const { return inner_loop.min(); }
+  constexpr value_type max() const { return inner_loop.max(); }
+
+  // Setpoint the inner loop is currently following.
+  constexpr value_type inner_setpoint() const { return inner_sp; }
+
+  constexpr std::uint32_t ratio() const { return period; }
+
+  // Steps the outer loop on the next call, e.g. after its setpoint changed.
+  constexpr void resync() { phase = 0; }
+
+  constexpr OuterT&       outer() { return outer_loop; }
+  constexpr const OuterT& outer() const { return outer_loop; }
+  constexpr InnerT&       inner() { return inner_loop; }
+  constexpr const InnerT& inner() const { return inner_loop; }
+
+private:
+  OuterT        outer_loop;
+  InnerT        inner_loop;
+  value_type    inner_sp{};
+  std::uint32_t period;
+  std::uint32_t phase = 0;
+};
+
+template<CascadeLoop OuterT, CascadeLoop InnerT>
+constexpr auto
+cascade(OuterT outer, InnerT inner, std::uint32_t ratio = 1)
+{
+  return Cascade<OuterT, InnerT>(std::move(outer), std::move(inner), ratio);
+}
+
+// Many cascades stepped together, with the outer and inner loops of axis i at index i of their banks.
+// All axes share the rate ratio, so the outer bank runs as one kernel call on every ratio-th call.
+template<typename OuterBankT, typename InnerBankT>
+  requires std::same_as<typename OuterBankT::value_type, typename InnerBankT::value_type>
+class CascadeBank
+{
+public:
+  using value_type = typename InnerBankT::value_type;
+
+  CascadeBank(OuterBankT outer, InnerBankT inner, std::uint32_t ratio = 1)
+    : outer_bank(std::move(outer))
+    , inner_bank(std::move(inner))
+    , period(ratio)
+  {
+    assert(0 < ratio);
+  }
+
+  void calculate(
+    std::span<const value_type> setpoints,
+    std::span<const value_type> outer_pvs,
+    std::span<const value_type> inner_pvs,
+    std::span<value_type>       out
+  )
+  {
+    assert(outer_bank.size() == inner_bank.size());
+    if (inner_sp.size() != inner_bank.size()) {
+      inner_sp.resize(inner_bank.size());
+      phase = 0;
+    }
+    if (phase == 0) {
+      outer_bank.calculate(setpoints, outer_pvs, inner_sp);
+      phase = period;
+    }
+    --phase;
+    inner_bank.calculate(inner_sp, inner_pvs, out);
+  }
+
+  std::size_t size() const { return inner_bank.size(); }
+
+  std::span<const value_type> inner_setpoints() const { return inner_sp; }
+
+  std::uint32_t ratio() const { return period; }
+
+  void resync() { phase = 0; }
+
+  // Axes are added by pushing one loop to each bank; the outer bank is stepped on the next call.
+  OuterBankT&       outer() { return outer_bank; }
+  const OuterBankT& outer() const { return outer_bank; }
+  InnerBankT&       inner() { return inner_bank; }
+  const InnerBankT& inner() const { return inner_bank; }
+
+private:
+  OuterBankT              outer_bank;
+  InnerBankT              inner_bank;
+  std::vector<value_type> inner_sp;
+  std::uint32_t           period;
+  std::uint32_t           phase = 0;
+};
+
+template<typename OuterBankT, typename InnerBankT>
+auto
+cascade_bank(OuterBankT outer, InnerBankT inner, std::uint32_t ratio = 1)
+{
+  return CascadeBank<OuterBankT, InnerBankT>(std::move(outer), std::move(inner), ratio);
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_CASCADE_HPP_
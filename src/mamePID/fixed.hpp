@@ -0,0 +1,250 @@
+#ifndef MAMEPID_FIXED_HPP_
+#define MAMEPID_FIXED_HPP_
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include <mamePID.hpp>
+
+namespace mamePID {
+
+namespace detail {
+
+template<typename Int>
+struct wider;
+
+template<>
+struct wider<std::int8_t>
+{
+  using type = std::int16_t;
+};
+
+template<>
+struct wider<std::int16_t>
+{
+  using type = std::int32_t;
+};
+
+template<>
+struct wider<std::int32_t>
+{
+  using type = std::int64_t;
+};
+
+#if defined(__SIZEOF_INT128__)
+template<>
+struct wider<std::int64_t>
+{
+  __extension__ typedef __int128 type;
+};
+#endif
+
+} // namespace detail
+
+// Saturating signed fixed-point number with FracBits fractional bits, e.g. Fixed<std::int16_t, 15> is Q15.
+// Every operation rounds to nearest and saturates at the representable range instead of wrapping.
+// Pick FracBits so that kd / dt and the controller limits fit in the integer part.
+template<typename Int, int FracBits>
+  requires std::is_same_v<Int, std::make_signed_t<Int>> && (0 < FracBits) &&
+           (FracBits <= std::numeric_limits<Int>::digits)
+class Fixed
+{
+public:
+  using raw_type  = Int;
+  using wide_type = typename detail::wider<Int>::type;
+
+  static constexpr int frac_bits = FracBits;
+
+  constexpr Fixed()
+    : value(0)
+  {
+  }
+
+  template<std::floating_point F>
+  constexpr Fixed(F v)
+    : value(from_floating(v))
+  {
+  }
+
+  template<std::integral I>
+  constexpr Fixed(I v)
+    : value(from_integral(v))
+  {
+  }
+
+  template<typename OtherInt, int OtherFracBits>
+  explicit constexpr Fixed(Fixed<OtherInt, OtherFracBits> other)
+    : value(rescale<OtherFracBits>(other.raw()))
+  {
+  }
+
+  static constexpr Fixed from_raw(Int raw)
+  {
+    Fixed fixed;
+    fixed.value = raw;
+    return fixed;
+  }
+
+  constexpr Int raw() const { return value; }
+
+  template<std::floating_point F>
+  explicit constexpr operator F() const
+  {
+    return static_cast<F>(value) / static_cast<F>(one);
+  }
+
+  friend constexpr Fixed operator+(Fixed a, Fixed b)
+  {
+    return from_raw(saturate(static_cast<wide_type>(a.value) + b.value));
+  }
+
+  friend constexpr Fixed operator-(Fixed a, Fixed b)
+  {
+    return from_raw(saturate(static_cast<wide_type>(a.value) - b.value));
+  }
+
+  friend constexpr Fixed operator*(Fixed a, Fixed b)
+  {
+    return from_raw(saturate(round_shift(static_cast<wide_type>(a.value) * b.value, FracBits)));
+  }
+
+  friend constexpr Fixed operator/(Fixed a, Fixed b)
+  {
+    if (b.value == 0) {
+      return a.value == 0 ? Fixed() : from_raw(a.value < 0 ? min_raw : max_raw);
+    }
+    // Round half away from zero.
+    const wide_type n     = static_cast<wide_type>(a.value) * one;
+    const wide_type d     = b.value;
+    wide_type       q     = n / d;
+    const wide_type r     = n % d;
+    const wide_type abs_r = r < 0 ? -r : r;
+    const wide_type abs_d = d < 0 ? -d : d;
+    if (abs_d <= 2 * abs_r) {
+      q += (n < 0) == (d < 0) ? 1 : -1;
+    }
+    return from_raw(saturate(q));
+  }
+
+  friend constexpr Fixed operator-(Fixed a) { return from_raw(saturate(-static_cast<wide_type>(a.value))); }
+
+  constexpr Fixed& operator+=(Fixed other) { return *this = *this + other; }
+  constexpr Fixed& operator-=(Fixed other) { return *this = *this - other; }
+  constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+  constexpr Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+  friend constexpr bool                 operator==(Fixed, Fixed) = default;
+  friend constexpr std::strong_ordering operator<=>(Fixed, Fixed) = default;
+
+private:
+  static constexpr Int       min_raw = std::numeric_limits<Int>::min();
+  static constexpr Int       max_raw = std::numeric_limits<Int>::max();
+  static constexpr wide_type one     = static_cast<wide_type>(1) << FracBits;
+
+  static constexpr Int saturate(wide_type v)
+  {
+    return v < min_raw ? min_raw : (max_raw < v ? max_raw : static_cast<Int>(v));
+  }
+
+  template<typename W>
+  static constexpr W round_shift(W v, int shift)
+  {
+    return (v + (static_cast<W>(1) << (shift - 1))) >> shift;
+  }
+
+  template<std::floating_point F>
+  static constexpr Int from_floating(F v)
+  {
+    const F scaled = v * static_cast<F>(one);
+    if (!(static_cast<F>(min_raw) < scaled)) {
+      return scaled != scaled ? 0 : min_raw;
+    }
+    if (!(scaled < static_cast<F>(max_raw))) {
+      return max_raw;
+    }
+    return static_cast<Int>(scaled < 0 ? -static_cast<wide_type>(-scaled + F(0.5))
+                                       : static_cast<wide_type>(scaled + F(0.5)));
+  }
+
+  template<std::integral I>
+  static constexpr Int from_integral(I v)
+  {
+    constexpr Int limit = max_raw >> FracBits;
+    if (std::cmp_greater(v, limit)) {
+      return max_raw;
+    }
+    if (std::cmp_less(v, -limit - 1)) {
+      return min_raw;
+    }
+    return static_cast<Int>(static_cast<wide_type>(v) * one);
+  }
+
+  template<int OtherFracBits, typename OtherInt>
+  static constexpr Int rescale(OtherInt raw)
+  {
+    using W = std::common_type_t<wide_type, typename detail::wider<OtherInt>::type>;
+    if constexpr (FracBits < OtherFracBits) {
+      const W v = round_shift(static_cast<W>(raw), OtherFracBits - FracBits);
+      return v < min_raw ? min_raw : (max_raw < v ? max_raw : static_cast<Int>(v));
+    } else {
+      constexpr W limit = (static_cast<W>(max_raw) >> (FracBits - OtherFracBits)) + 1;
+      if (limit <= raw) {
+        return max_raw;
+      }
+      if (raw < -limit) {
+        return min_raw;
+      }
+      return static_cast<Int>(static_cast<W>(raw) * (static_cast<W>(1) << (FracBits - OtherFracBits)));
+    }
+  }
+
+  Int value;
+};
+
+using Q15 = Fixed<std::int16_t, 15>;
+using Q31 = Fixed<std::int32_t, 31>;
+
+// The integrator accumulates ki * error at twice the fractional precision, so increments smaller than
+// one LSB of the controller type are not rounded away on every step.
+template<typename Int, int FracBits>
+  requires(!std::is_same_v<Int, std::int64_t>)
+struct accumulator<Fixed<Int, FracBits>>
+{
+  using type = Fixed<typename detail::wider<Int>::type, 2 * FracBits>;
+};
+
+// Saturating multiply-accumulate, rounded once after the addition.
+template<typename Int, int FracBits>
+constexpr Fixed<Int, FracBits>
+mac(Fixed<Int, FracBits> acc, Fixed<Int, FracBits> a, Fixed<Int, FracBits> b)
+{
+  using A = accumulator_t<Fixed<Int, FracBits>>;
+  return Fixed<Int, FracBits>(A(acc) + A(a) * A(b));
+}
+
+} // namespace mamePID
+
+template<typename Int, int FracBits>
+struct std::numeric_limits<mamePID::Fixed<Int, FracBits>>
+{
+  using type = mamePID::Fixed<Int, FracBits>;
+
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed      = true;
+  static constexpr bool is_integer     = false;
+  static constexpr bool is_exact       = true;
+  static constexpr bool is_bounded     = true;
+  static constexpr int  digits         = std::numeric_limits<Int>::digits;
+  static constexpr int  radix          = 2;
+
+  static constexpr type min() noexcept { return type::from_raw(std::numeric_limits<Int>::min()); }
+  static constexpr type lowest() noexcept { return type::from_raw(std::numeric_limits<Int>::min()); }
+  static constexpr type max() noexcept { return type::from_raw(std::numeric_limits<Int>::max()); }
+  static constexpr type epsilon() noexcept { return type::from_raw(1); }
+};
+
+#endif // MAMEPID_FIXED_HPP_
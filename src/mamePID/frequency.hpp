@@ -0,0 +1,201 @@
+#ifndef MAMEPID_FREQUENCY_HPP_
+#define MAMEPID_FREQUENCY_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/simulation.hpp>
+
+namespace mamePID {
+
+template<typename C>
+concept Analyzable = requires(const C c, std::complex<typename C::value_type> z) {
+  { c.response(z) } -> std::same_as<Response<typename C::value_type>>;
+};
+
+// n angular frequencies from lo to hi, evenly spaced on a logarithmic scale.
+template<std::floating_point T>
+std::vector<T>
+log_grid(T lo, T hi, std::size_t n)
+{
+  assert(T(0) < lo && lo < hi && 1 < n);
+  std::vector<T> omega(n);
+  const T        ratio = std::log(hi / lo) / T(n - 1);
+  for (std::size_t k = 0; k < n; ++k) {
+    omega[k] = lo * std::exp(ratio * T(k));
+  }
+  return omega;
+}
+
+// The plant at z, including its dead time.
+template<std::floating_point T>
+std::complex<T>
+response(const TransferFunction<T>& model, std::complex<T> z)
+{
+  const auto      x = T(1) / z;
+  std::complex<T> num{}, den{}, power{ T(1) };
+  for (std::size_t j = 0; j <= model.order(); ++j) {
+    num   += model.numerator()[j] * power;
+    den   += model.denominator()[j] * power;
+    power *= x;
+  }
+  return num / den * std::pow(x, T(model.delay()));
+}
+
+// Stability margins of an open loop. The gain margin is the factor the loop gain may grow by before the
+// loop becomes unstable, taken where the phase crosses -180 degrees; the phase margin, in degrees, is
+// taken where the magnitude crosses 1. With several crossings the smallest margin is reported. A margin
+// without a crossing on the grid is infinite, and its crossover frequency is NaN.
+template<typename T>
+struct Margins
+{
+  T gain            = std::numeric_limits<T>::infinity();
+  T phase           = std::numeric_limits<T>::infinity();
+  T phase_crossover = std::numeric_limits<T>::quiet_NaN();
+  T gain_crossover  = std::numeric_limits<T>::quiet_NaN();
+};
+
+namespace detail {
+
+// Updates margins with the crossings between two neighbouring grid points, interpolated linearly in
+// log-frequency.
+template<typename T>
+void
+crossings(std::complex<T> l0, std::complex<T> l1, T w0, T w1, Margins<T>& margins)
+{
+  const T m0 = std::norm(l0);
+  const T m1 = std::norm(l1);
+  if ((T(1) <= m0) != (T(1) <= m1)) {
+    const T f     = std::log(m0) / (std::log(m0) - std::log(m1));
+    const T phase = std::arg(-(l0 + f * (l1 - l0))) * T(180) / std::numbers::pi_v<T>;
+    if (phase < margins.phase) {
+      margins.phase          = phase;
+      margins.gain_crossover = w0 * std::pow(w1 / w0, f);
+    }
+  }
+  if ((l0.imag() < T(0)) != (l1.imag() < T(0))) {
+    const T f  = l0.imag() / (l0.imag() - l1.imag());
+    const T re = l0.real() + f * (l1.real() - l0.real());
+    if (re < T(0) && T(-1) / re < margins.gain) {
+      margins.gain            = T(-1) / re;
+      margins.phase_crossover = w0 * std::pow(w1 / w0, f);
+    }
+  }
+}
+
+} // namespace detail
+
+// Open loop of controller and model at the angular frequencies omega, in rad/s and below the Nyquist
+// frequency pi / dt. The loop is closed as in sweep(): the controller reads the output of the previous
+// sample, which adds one sample of delay to the plant.
+template<Analyzable C>
+std::vector<std::complex<typename C::value_type>>
+open_loop(
+  const C&                                                      controller,
+  const TransferFunction<typename C::value_type>&               model,
+  std::span<const std::type_identity_t<typename C::value_type>> omega
+)
+{
+  using T = typename C::value_type;
+  std::vector<std::complex<T>> loop(omega.size());
+  for (std::size_t k = 0; k < omega.size(); ++k) {
+    const auto z = std::polar(T(1), omega[k] * model.dt());
+    loop[k]      = controller.response(z).feedback * response(model, z) / z;
+  }
+  return loop;
+}
+
+template<std::floating_point T>
+Margins<T>
+margins(std::span<const std::complex<T>> loop, std::span<const std::type_identity_t<T>> omega)
+{
+  assert(loop.size() == omega.size());
+  Margins<T> result;
+  for (std::size_t k = 1; k < loop.size(); ++k) {
+    detail::crossings(loop[k - 1], loop[k], omega[k - 1], omega[k], result);
+  }
+  return result;
+}
+
+template<Analyzable C>
+Margins<typename C::value_type>
+margins(
+  const C&                                                      controller,
+  const TransferFunction<typename C::value_type>&               model,
+  std::span<const std::type_identity_t<typename C::value_type>> omega
+)
+{
+  using T         = typename C::value_type;
+  const auto loop = open_loop(controller, model, omega);
+  return margins(std::span<const std::complex<T>>(loop), omega);
+}
+
+// Margins of many loops around the same model, one per element of loops, with the discretization of
+// Integral and Derivative at the sampling period of model. The feedback path of the PID, PI-D and I-PD
+// architectures is the same, so this covers every PIDBank without a derivative filter.
+// The loop is linear in the gains: L = kp * P + ki * I * P + kd * D * P with P the delayed plant, so the
+// three products are evaluated once per frequency and the loops are a few multiply-adds each, computed
+// as separate real and imaginary arrays over blocks of loops.
+template<std::floating_point T>
+std::vector<Margins<T>>
+bank_margins(
+  std::span<const Gains<std::type_identity_t<T>>> loops,
+  const TransferFunction<T>&                      model,
+  std::span<const std::type_identity_t<T>>        omega
+)
+{
+  const T                      dt = model.dt();
+  const std::size_t            m  = omega.size();
+  std::vector<std::complex<T>> p(m), ip(m), dp(m);
+  for (std::size_t k = 0; k < m; ++k) {
+    const auto z = std::polar(T(1), omega[k] * dt);
+    p[k]         = response(model, z) / z;
+    ip[k]        = p[k] * dt * z / (z - T(1));
+    dp[k]        = p[k] * (T(1) - T(1) / z) / dt;
+  }
+
+  constexpr std::size_t   block = 256;
+  std::vector<Margins<T>> result(loops.size());
+  std::vector<T>          kp(block), ki(block), kd(block), re0(block), im0(block), re1(block), im1(block);
+  for (std::size_t begin = 0; begin < loops.size(); begin += block) {
+    const std::size_t n = std::min(block, loops.size() - begin);
+    for (std::size_t i = 0; i < n; ++i) {
+      kp[i] = loops[begin + i].kp;
+      ki[i] = loops[begin + i].ki;
+      kd[i] = loops[begin + i].kd;
+    }
+    for (std::size_t k = 0; k < m; ++k) {
+      const T pr = p[k].real(), pim = p[k].imag();
+      const T ir = ip[k].real(), iim = ip[k].imag();
+      const T dr = dp[k].real(), dim = dp[k].imag();
+      for (std::size_t i = 0; i < n; ++i) {
+        re1[i] = kp[i] * pr + ki[i] * ir + kd[i] * dr;
+        im1[i] = kp[i] * pim + ki[i] * iim + kd[i] * dim;
+      }
+      if (k != 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+          detail::crossings(
+            { re0[i], im0[i] }, { re1[i], im1[i] }, omega[k - 1], omega[k], result[begin + i]
+          );
+        }
+      }
+      std::swap(re0, re1);
+      std::swap(im0, im1);
+    }
+  }
+  return result;
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_FREQUENCY_HPP_
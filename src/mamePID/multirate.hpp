@@ -0,0 +1,236 @@
+#ifndef MAMEPID_MULTIRATE_HPP_
+#define MAMEPID_MULTIRATE_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/aligned.hpp>
+
+namespace mamePID {
+
+// Controllers sharing one sample period and offset. Timings are measured with the scheduler's clock:
+// elapsed is the time spent stepping the group, finish the time from the start of the tick to the end of
+// the group. A run overruns when it finishes later than the deadline after the start of its tick.
+struct RateGroupStats
+{
+  std::chrono::nanoseconds period{};
+  std::chrono::nanoseconds offset{};
+  std::chrono::nanoseconds deadline{};
+  std::size_t              controllers = 0;
+  std::uint64_t            runs        = 0;
+  std::uint64_t            overruns    = 0;
+  std::chrono::nanoseconds elapsed{};
+  std::chrono::nanoseconds worst{};
+  std::chrono::nanoseconds finish{};
+};
+
+// One base tick of a RateScheduler. Bit g of due and overruns stands for RateScheduler::group(g).
+struct RateTick
+{
+  std::uint64_t            tick     = 0;
+  std::uint64_t            due      = 0;
+  std::uint64_t            overruns = 0;
+  std::chrono::nanoseconds wall{};
+};
+
+// Steps controllers with different sample periods from one base tick. Every period and offset is a whole
+// number of base ticks; controllers with the same period and offset form a group, stored contiguously.
+// The due groups of every tick in the hyperperiod, the least common multiple of the periods, are
+// precomputed as a bitmap, so a tick only touches the groups it steps. Due groups run in order of
+// increasing period, the rate-monotonic order, and each is checked against its deadline, its period by
+// default.
+// Controllers must be built with the sampling period of their group. At most 64 groups are supported, and
+// the hyperperiod is limited to max_hyperperiod base ticks; add() throws std::length_error beyond either.
+template<typename ControllerT, typename Clock = std::chrono::steady_clock>
+  requires Component<ControllerT, typename ControllerT::value_type>
+class RateScheduler
+{
+public:
+  using value_type = typename ControllerT::value_type;
+
+  explicit RateScheduler(std::chrono::nanoseconds base, std::size_t max_hyperperiod = std::size_t{ 1 } << 20)
+    : base(base)
+    , max_hyperperiod(max_hyperperiod)
+  {
+    assert(base.count() > 0);
+  }
+
+  // Adds a controller to the group of period and offset and returns its index into the spans of tick().
+  std::size_t add(
+    ControllerT              controller,
+    std::chrono::nanoseconds period,
+    std::chrono::nanoseconds offset = std::chrono::nanoseconds::zero()
+  )
+  {
+    Group& group = group_of(period, offset);
+    locations.push_back({ &group, group.controllers.size() });
+    group.controllers.push_back(std::move(controller));
+    group.index.push_back(locations.size() - 1);
+    ++group.stats.controllers;
+    return locations.size() - 1;
+  }
+
+  // Deadline of the group of period and offset, measured from the start of its tick.
+  void set_deadline(
+    std::chrono::nanoseconds period,
+    std::chrono::nanoseconds offset,
+    std::chrono::nanoseconds deadline
+  )
+  {
+    group_of(period, offset).stats.deadline = deadline;
+  }
+
+  std::size_t size() const { return locations.size(); }
+
+  ControllerT& operator[](std::size_t i)
+  {
+    assert(i < locations.size());
+    return locations[i].group->controllers[locations[i].position];
+  }
+
+  std::chrono::nanoseconds base_period() const { return base; }
+
+  // Length of the schedule in base ticks.
+  std::size_t hyperperiod() const { return due.size(); }
+
+  // Groups due on the given base tick.
+  std::uint64_t due_on(std::uint64_t tick) const { return due[tick % due.size()]; }
+
+  std::size_t group_count() const { return groups.size(); }
+
+  const RateGroupStats& group(std::size_t g) const
+  {
+    assert(g < groups.size());
+    return groups[g]->stats;
+  }
+
+  // Steps the controllers of every group due on the current base tick: out[i] = calculate(setpoints[i],
+  // pvs[i]) for each of their indices. The outputs of the other controllers are left as they are.
+  const RateTick& tick(
+    std::span<const value_type> setpoints,
+    std::span<const value_type> pvs,
+    std::span<value_type>       out
+  )
+  {
+    assert(setpoints.size() == size() && pvs.size() == size() && out.size() == size());
+
+    const auto start = Clock::now();
+    last             = { count, due[phase], 0, {} };
+    auto now         = start;
+    for (std::uint64_t pending = last.due; pending != 0; pending &= pending - 1) {
+      const auto g     = static_cast<std::size_t>(std::countr_zero(pending));
+      Group&     group = *groups[g];
+      for (std::size_t j = 0; j < group.controllers.size(); ++j) {
+        const std::size_t i = group.index[j];
+        out[i]              = group.controllers[j].calculate(setpoints[i], pvs[i]);
+      }
+
+      const auto end   = Clock::now();
+      auto&      stats = group.stats;
+      stats.elapsed    = std::chrono::duration_cast<std::chrono::nanoseconds>(end - now);
+      stats.finish     = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+      stats.worst      = std::max(stats.worst, stats.elapsed);
+      ++stats.runs;
+      if (stats.deadline < stats.finish) {
+        ++stats.overruns;
+        last.overruns |= std::uint64_t{ 1 } << g;
+      }
+      now = end;
+    }
+    last.wall = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start);
+
+    ++count;
+    phase = phase + 1 == due.size() ? 0 : phase + 1;
+    return last;
+  }
+
+  const RateTick& last_tick() const { return last; }
+
+private:
+  struct Group
+  {
+    std::uint64_t                                                        ticks;
+    std::uint64_t                                                        shift;
+    std::vector<ControllerT, detail::CacheAlignedAllocator<ControllerT>> controllers;
+    std::vector<std::size_t>                                             index;
+    RateGroupStats                                                       stats;
+  };
+
+  struct Location
+  {
+    Group*      group;
+    std::size_t position;
+  };
+
+  Group& group_of(std::chrono::nanoseconds period, std::chrono::nanoseconds offset)
+  {
+    assert(period.count() > 0 && period % base == std::chrono::nanoseconds::zero());
+    assert(offset.count() >= 0 && offset % base == std::chrono::nanoseconds::zero() && offset < period);
+
+    const auto ticks = static_cast<std::uint64_t>(period / base);
+    const auto shift = static_cast<std::uint64_t>(offset / base);
+    const auto key   = std::pair(ticks, shift);
+    auto       it    = std::lower_bound(groups.begin(), groups.end(), key, [](const auto& group, auto value) {
+      return std::pair(group->ticks, group->shift) < value;
+    });
+    if (it != groups.end() && (*it)->ticks == ticks && (*it)->shift == shift) {
+      return **it;
+    }
+    if (groups.size() == 64) {
+      throw std::length_error("mamePID: too many rate groups");
+    }
+    // The new hyperperiod, due.size() / gcd * ticks, is checked without overflowing.
+    if (max_hyperperiod / ticks < due.size() / std::gcd<std::uint64_t>(due.size(), ticks)) {
+      throw std::length_error("mamePID: hyperperiod too long");
+    }
+    auto group            = std::make_unique<Group>();
+    group->ticks          = ticks;
+    group->shift          = shift;
+    group->stats.period   = period;
+    group->stats.offset   = offset;
+    group->stats.deadline = period;
+    it                    = groups.insert(it, std::move(group));
+    rebuild();
+    return **it;
+  }
+
+  // Recomputes the bitmaps after the groups changed, keeping the position in the schedule.
+  void rebuild()
+  {
+    std::uint64_t length = 1;
+    for (const auto& group : groups) {
+      length = std::lcm(length, group->ticks);
+    }
+    due.assign(length, 0);
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+      for (std::uint64_t t = groups[g]->shift; t < length; t += groups[g]->ticks) {
+        due[t] |= std::uint64_t{ 1 } << g;
+      }
+    }
+    phase = count % length;
+  }
+
+  std::chrono::nanoseconds            base;
+  std::size_t                         max_hyperperiod;
+  std::vector<std::unique_ptr<Group>> groups;
+  std::vector<Location>               locations;
+  std::vector<std::uint64_t>          due{ 0 };
+  std::uint64_t                       count = 0;
+  std::size_t                         phase = 0;
+  RateTick                            last;
+};
+
+} // namespace mamePID
+
+#endif // MAMEPID_MULTIRATE_HPP_
@@ -0,0 +1,228 @@
+#ifndef MAMEPID_REGISTRY_HPP_
+#define MAMEPID_REGISTRY_HPP_
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/aligned.hpp>
+
+namespace mamePID {
+
+// Refers to one controller in a ControllerPool. A handle stays valid while its controller is alive, no
+// matter how often the pool compacts, and is rejected once the controller has been erased.
+template<typename C>
+struct Handle
+{
+  static constexpr std::uint32_t invalid = std::numeric_limits<std::uint32_t>::max();
+
+  std::uint32_t index      = invalid;
+  std::uint32_t generation = 0;
+
+  friend bool operator==(Handle, Handle) = default;
+};
+
+// Controllers of one composition type packed into a single cache-line aligned array. Erasing moves the
+// last controller into the hole, so stepping the pool always walks contiguous memory.
+template<std::movable C>
+class ControllerPool
+{
+public:
+  using controller_type = C;
+  using handle_type     = Handle<C>;
+
+  void reserve(std::size_t n)
+  {
+    dense.reserve(n);
+    owner.reserve(n);
+    slots.reserve(n);
+  }
+
+  template<typename... Args>
+  Handle<C> emplace(Args&&... args)
+  {
+    std::uint32_t index;
+    if (free_head != Handle<C>::invalid) {
+      index     = free_head;
+      free_head = slots[index].dense;
+    } else {
+      assert(slots.size() < Handle<C>::invalid);
+      index = static_cast<std::uint32_t>(slots.size());
+      slots.push_back({});
+    }
+    dense.emplace_back(std::forward<Args>(args)...);
+    owner.push_back(index);
+    slots[index].dense = static_cast<std::uint32_t>(dense.size() - 1);
+    return { index, slots[index].generation };
+  }
+
+  Handle<C> insert(C controller) { return emplace(std::move(controller)); }
+
+  // Returns false if the handle was stale.
+  bool erase(Handle<C> handle)
+  {
+    if (!contains(handle)) {
+      return false;
+    }
+    const std::uint32_t position = slots[handle.index].dense;
+    const std::uint32_t last     = static_cast<std::uint32_t>(dense.size() - 1);
+    if (position != last) {
+      dense[position]              = std::move(dense[last]);
+      owner[position]              = owner[last];
+      slots[owner[position]].dense = position;
+    }
+    dense.pop_back();
+    owner.pop_back();
+    ++slots[handle.index].generation;
+    slots[handle.index].dense = free_head;
+    free_head                 = handle.index;
+    return true;
+  }
+
+  bool contains(Handle<C> handle) const
+  {
+    return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+  }
+
+  // The controller, or nullptr if the handle is stale. The pointer is invalidated by the next insert or
+  // erase on this pool.
+  C* get(Handle<C> handle) { return contains(handle) ? &dense[slots[handle.index].dense] : nullptr; }
+
+  const C* get(Handle<C> handle) const
+  {
+    return contains(handle) ? &dense[slots[handle.index].dense] : nullptr;
+  }
+
+  // Handle of the controller at position i of controllers().
+  Handle<C> handle_at(std::size_t i) const { return { owner[i], slots[owner[i]].generation }; }
+
+  std::span<C>       controllers() { return dense; }
+  std::span<const C> controllers() const { return dense; }
+
+  auto begin() { return dense.begin(); }
+  auto end() { return dense.end(); }
+  auto begin() const { return dense.begin(); }
+  auto end() const { return dense.end(); }
+
+  std::size_t size() const { return dense.size(); }
+  bool        empty() const { return dense.empty(); }
+
+  // Erases every controller; all outstanding handles become stale.
+  void clear()
+  {
+    while (!dense.empty()) {
+      erase(handle_at(dense.size() - 1));
+    }
+  }
+
+private:
+  struct Slot
+  {
+    // Position in dense while the slot is live, the next free slot otherwise.
+    std::uint32_t dense      = 0;
+    std::uint32_t generation = 0;
+  };
+
+  std::vector<C, detail::CacheAlignedAllocator<C>> dense;
+  std::vector<std::uint32_t>                       owner;
+  std::vector<Slot>                                slots;
+  std::uint32_t                                    free_head = Handle<C>::invalid;
+};
+
+// A dynamic population of controllers of the listed composition types, each type in its own pool.
+template<std::movable... Cs>
+class Registry
+{
+  template<typename C>
+  static constexpr bool holds = ((std::same_as<C, Cs> ? 1 : 0) + ... + 0) == 1;
+
+public:
+  template<typename C>
+    requires holds<C>
+  ControllerPool<C>& pool()
+  {
+    return std::get<ControllerPool<C>>(pools);
+  }
+
+  template<typename C>
+    requires holds<C>
+  const ControllerPool<C>& pool() const
+  {
+    return std::get<ControllerPool<C>>(pools);
+  }
+
+  template<typename C>
+    requires holds<std::remove_cvref_t<C>>
+  Handle<std::remove_cvref_t<C>> insert(C&& controller)
+  {
+    return pool<std::remove_cvref_t<C>>().emplace(std::forward<C>(controller));
+  }
+
+  template<typename C, typename... Args>
+    requires holds<C>
+  Handle<C> emplace(Args&&... args)
+  {
+    return pool<C>().emplace(std::forward<Args>(args)...);
+  }
+
+  template<typename C>
+    requires holds<C>
+  bool erase(Handle<C> handle)
+  {
+    return pool<C>().erase(handle);
+  }
+
+  template<typename C>
+    requires holds<C>
+  C* get(Handle<C> handle)
+  {
+    return pool<C>().get(handle);
+  }
+
+  template<typename C>
+    requires holds<C>
+  bool contains(Handle<C> handle) const
+  {
+    return pool<C>().contains(handle);
+  }
+
+  std::size_t size() const
+  {
+    return std::apply([](const auto&... pool) { return (pool.size() + ... + std::size_t(0)); }, pools);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  // Calls f on every controller, one pool after another in storage order.
+  template<typename F>
+  void for_each(F&& f)
+  {
+    for_each_pool([&](auto& pool) {
+      for (auto& controller : pool) {
+        f(controller);
+      }
+    });
+  }
+
+  // Calls f once per pool, for loops that want the typed pool, e.g. to look up handles.
+  template<typename F>
+  void for_each_pool(F&& f)
+  {
+    std::apply([&](auto&... pool) { (f(pool), ...); }, pools);
+  }
+
+private:
+  std::tuple<ControllerPool<Cs>...> pools;
+};
+
+} // namespace mamePID
+
+#endif // MAMEPID_REGISTRY_HPP_
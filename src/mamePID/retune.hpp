@@ -0,0 +1,158 @@
+#ifndef MAMEPID_RETUNE_HPP_
+#define MAMEPID_RETUNE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+#include <mamePID.hpp>
+#include <mamePID/aligned.hpp>
+#include <mamePID/spsc.hpp>
+
+namespace mamePID {
+
+// Hands the latest gain set from one tuning thread to one control thread through three buffers.
+// Both sides are wait-free: publish overwrites a set that has not been fetched yet, and fetch never sees a
+// partially written set.
+template<typename T>
+class GainMailbox
+{
+public:
+  // Tuning thread.
+  void publish(const Gains<T>& gains)
+  {
+    slots[back].gains = gains;
+    back              = latest.exchange(back | fresh, std::memory_order_acq_rel) & index;
+  }
+
+  // Control thread. Returns the most recently published set, or nullptr if nothing was published since the
+  // last call. The pointer stays valid until the next call.
+  const Gains<T>* fetch()
+  {
+    if (!(latest.load(std::memory_order_relaxed) & fresh)) {
+      return nullptr;
+    }
+    front = latest.exchange(front, std::memory_order_acq_rel) & index;
+    return &slots[front].gains;
+  }
+
+private:
+  static constexpr unsigned index = 0b011;
+  static constexpr unsigned fresh = 0b100;
+
+  struct alignas(detail::cache_line) Slot
+  {
+    Gains<T> gains;
+  };
+
+  std::array<Slot, 3> slots{};
+  alignas(detail::cache_line) std::atomic<unsigned> latest{ 1 };
+  alignas(detail::cache_line) unsigned back  = 0;
+  alignas(detail::cache_line) unsigned front = 2;
+};
+
+template<typename ControllerT>
+concept GainsMutable = requires(ControllerT controller, Gains<typename ControllerT::value_type> gains) {
+  controller.setGains(gains);
+};
+
+// A controller whose gains can be replaced from another thread. New gains take effect at the start of the
+// next calculate() call; the controller state is kept.
+template<GainsMutable ControllerT>
+class Retunable
+{
+public:
+  using value_type = typename ControllerT::value_type;
+
+  explicit Retunable(ControllerT controller)
+    : controller(std::move(controller))
+  {
+  }
+
+  void publish(const Gains<value_type>& gains) { mailbox.publish(gains); }
+
+  value_type calculate(value_type setpoint, value_type pv)
+  {
+    if (const auto* gains = mailbox.fetch()) {
+      controller.setGains(*gains);
+    }
+    return controller.calculate(setpoint, pv);
+  }
+
+  ControllerT&       get() { return controller; }
+  const ControllerT& get() const { return controller; }
+
+private:
+  ControllerT             controller;
+  GainMailbox<value_type> mailbox;
+};
+
+template<typename ControllerT>
+auto
+retunable(ControllerT controller)
+{
+  return Retunable<ControllerT>(std::move(controller));
+}
+
+template<typename T>
+struct GainUpdate
+{
+  std::size_t index;
+  Gains<T>    gains;
+};
+
+// A bank whose per-loop gains can be replaced from another thread. Updates are queued and applied before
+// the next calculate() call, at most Capacity of them per call so a busy tuner cannot stall the loop.
+template<typename BankT, std::size_t Capacity = 256>
+class RetunableBank
+{
+public:
+  using value_type = typename BankT::value_type;
+
+  explicit RetunableBank(BankT bank)
+    : bank(std::move(bank))
+  {
+  }
+
+  // Returns false if the queue is full; the update is dropped and can be published again.
+  bool publish(std::size_t index, const Gains<value_type>& gains)
+  {
+    return updates.try_push({ index, gains });
+  }
+
+  void calculate(
+    std::span<const value_type> setpoints,
+    std::span<const value_type> pvs,
+    std::span<value_type>       out
+  )
+  {
+    for (std::size_t n = 0; n < Capacity; ++n) {
+      const auto update = updates.try_pop();
+      if (!update) {
+        break;
+      }
+      bank.set_gains(update->index, update->gains);
+    }
+    bank.calculate(setpoints, pvs, out);
+  }
+
+  BankT&       get() { return bank; }
+  const BankT& get() const { return bank; }
+
+private:
+  BankT                                      bank;
+  SpscRing<GainUpdate<value_type>, Capacity> updates;
+};
+
+template<typename BankT>
+auto
+retunable_bank(BankT bank)
+{
+  return RetunableBank<BankT>(std::move(bank));
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_RETUNE_HPP_
@@ -0,0 +1,248 @@
+#ifndef MAMEPID_SCHEDULER_HPP_
+#define MAMEPID_SCHEDULER_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <mamePID.hpp>
+#include <mamePID/aligned.hpp>
+
+namespace mamePID {
+
+struct SchedulerOptions
+{
+  // Number of worker threads; 0 uses std::thread::hardware_concurrency().
+  std::size_t workers = 0;
+  // Pin worker i to CPU i modulo the number of CPUs. Only implemented on Linux.
+  bool pin = true;
+  // Controllers per unit of work stealing; 0 picks a size that covers whole cache lines.
+  std::size_t block = 0;
+};
+
+struct ShardLoad
+{
+  // Controllers stepped by the worker, including stolen ones.
+  std::size_t              controllers   = 0;
+  std::size_t              stolen_blocks = 0;
+  std::chrono::nanoseconds busy{};
+};
+
+struct TickStats
+{
+  std::chrono::nanoseconds wall{};
+  std::vector<ShardLoad>   shards;
+};
+
+// Steps a fixed population of controllers on a pool of worker threads, once per controller per tick.
+// Controllers are split into one contiguous, cache-line aligned shard per worker. A worker that finishes its
+// own shard steals blocks from the others, so uneven shards still finish together.
+template<typename ControllerT>
+  requires Component<ControllerT, typename ControllerT::value_type>
+class Scheduler
+{
+public:
+  using value_type = typename ControllerT::value_type;
+
+  explicit Scheduler(std::span<const ControllerT> controllers, SchedulerOptions options = {})
+    : count(controllers.size())
+    , block(options.block != 0 ? options.block : default_block())
+    , done(static_cast<std::ptrdiff_t>(worker_count(options) + 1))
+  {
+    const std::size_t workers = worker_count(options);
+    stats.shards.resize(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+      auto              shard = std::make_unique<Shard>();
+      const std::size_t begin = count * i / workers;
+      const std::size_t end   = count * (i + 1) / workers;
+      shard->offset           = begin;
+      shard->blocks           = (end - begin + block - 1) / block;
+      shard->controllers.reserve(end - begin);
+      for (std::size_t j = begin; j < end; ++j) {
+        shard->controllers.push_back(controllers[j]);
+      }
+      shards.push_back(std::move(shard));
+    }
+
+    for (std::size_t i = 0; i < workers; ++i) {
+      threads.emplace_back([this, i] { work(i); });
+      if (options.pin) {
+        pin(threads.back(), i);
+      }
+    }
+  }
+
+  Scheduler(const Scheduler&)            = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  ~Scheduler()
+  {
+    stopping.store(true, std::memory_order_relaxed);
+    epoch.fetch_add(1, std::memory_order_release);
+    epoch.notify_all();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  std::size_t size() const { return count; }
+  std::size_t workers() const { return shards.size(); }
+
+  ControllerT& operator[](std::size_t i)
+  {
+    assert(i < count);
+    auto& shard = shard_of(i);
+    return shard.controllers[i - shard.offset];
+  }
+
+  // Calls calculate(setpoints[i], pvs[i]) on every controller and stores the result in out[i].
+  // Must not be called concurrently with itself.
+  const TickStats& tick(
+    std::span<const value_type> setpoints,
+    std::span<const value_type> pvs,
+    std::span<value_type>       out
+  )
+  {
+    assert(setpoints.size() == count && pvs.size() == count && out.size() == count);
+
+    this->setpoints = setpoints.data();
+    this->pvs       = pvs.data();
+    this->out       = out.data();
+    for (auto& shard : shards) {
+      shard->next.store(0, std::memory_order_relaxed);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    epoch.fetch_add(1, std::memory_order_release);
+    epoch.notify_all();
+    done.arrive_and_wait();
+    stats.wall = std::chrono::steady_clock::now() - start;
+
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+      stats.shards[i] = shards[i]->load;
+    }
+    return stats;
+  }
+
+  const TickStats& last_tick() const { return stats; }
+
+private:
+  struct alignas(detail::cache_line) Shard
+  {
+    std::vector<ControllerT, detail::CacheAlignedAllocator<ControllerT>> controllers;
+    std::size_t                                                          offset = 0;
+    std::size_t                                                          blocks = 0;
+    alignas(detail::cache_line) std::atomic<std::size_t> next{ 0 };
+    alignas(detail::cache_line) ShardLoad load;
+  };
+
+  static std::size_t worker_count(const SchedulerOptions& options)
+  {
+    if (options.workers != 0) {
+      return options.workers;
+    }
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  // At least 256 controllers, and a whole number of cache lines so stolen blocks do not share one.
+  static constexpr std::size_t default_block()
+  {
+    const std::size_t per_line = detail::cache_line / std::gcd(sizeof(ControllerT), detail::cache_line);
+    return (256 + per_line - 1) / per_line * per_line;
+  }
+
+  static void pin([[maybe_unused]] std::thread& thread, [[maybe_unused]] std::size_t worker)
+  {
+#if defined(__linux__)
+    const unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t      set;
+    CPU_ZERO(&set);
+    CPU_SET(worker % cpus, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+  }
+
+  Shard& shard_of(std::size_t i)
+  {
+    auto it = std::upper_bound(shards.begin(), shards.end(), i, [](std::size_t i, const auto& shard) {
+      return i < shard->offset;
+    });
+    return **(it - 1);
+  }
+
+  // Steps blocks of the shard until none are left and returns the number of blocks taken.
+  std::size_t run(Shard& shard, ShardLoad& load)
+  {
+    std::size_t taken = 0;
+    for (;;) {
+      const std::size_t b = shard.next.fetch_add(1, std::memory_order_relaxed);
+      if (shard.blocks <= b) {
+        return taken;
+      }
+      const std::size_t begin = b * block;
+      const std::size_t end   = std::min(begin + block, shard.controllers.size());
+      for (std::size_t j = begin; j < end; ++j) {
+        const std::size_t i = shard.offset + j;
+        out[i]              = shard.controllers[j].calculate(setpoints[i], pvs[i]);
+      }
+      load.controllers += end - begin;
+      ++taken;
+    }
+  }
+
+  void work(std::size_t id)
+  {
+    std::uint64_t seen = 0;
+    for (;;) {
+      epoch.wait(seen, std::memory_order_acquire);
+      seen = epoch.load(std::memory_order_acquire);
+      if (stopping.load(std::memory_order_relaxed)) {
+        return;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      ShardLoad  load;
+      run(*shards[id], load);
+      for (std::size_t k = 1; k < shards.size(); ++k) {
+        load.stolen_blocks += run(*shards[(id + k) % shards.size()], load);
+      }
+      load.busy        = std::chrono::steady_clock::now() - start;
+      shards[id]->load = load;
+
+      done.arrive_and_wait();
+    }
+  }
+
+  const std::size_t                   count;
+  const std::size_t                   block;
+  std::vector<std::unique_ptr<Shard>> shards;
+  std::vector<std::thread>            threads;
+  std::barrier<>                      done;
+  TickStats                           stats;
+
+  const value_type* setpoints = nullptr;
+  const value_type* pvs       = nullptr;
+  value_type*       out       = nullptr;
+
+  alignas(detail::cache_line) std::atomic<std::uint64_t> epoch{ 0 };
+  std::atomic<bool> stopping{ false };
+};
+
+} // namespace mamePID
+
+#endif // MAMEPID_SCHEDULER_HPP_
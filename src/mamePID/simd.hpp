@@ -0,0 +1,558 @@
+#ifndef MAMEPID_SIMD_HPP_
+#define MAMEPID_SIMD_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <mamePID.hpp>
+#include <mamePID/fixed.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MAMEPID_SIMD_X86 1
+#else
+#define MAMEPID_SIMD_X86 0
+#endif
+
+// The vector kernels must round exactly like the scalar path, so multiply-add contraction is disabled in
+// both, whatever -march or -ffp-contract the including code is built with.
+#if defined(__clang__)
+#define MAMEPID_SIMD_NO_CONTRACT _Pragma("clang fp contract(off)")
+#define MAMEPID_SIMD_SCALAR
+#define MAMEPID_SIMD_TARGET(isa) [[gnu::target(isa)]]
+#elif defined(__GNUC__)
+#define MAMEPID_SIMD_NO_CONTRACT
+#define MAMEPID_SIMD_SCALAR [[gnu::optimize("fp-contract=off")]]
+#define MAMEPID_SIMD_TARGET(isa) [[gnu::target(isa), gnu::optimize("fp-contract=off")]]
+#else
+#define MAMEPID_SIMD_NO_CONTRACT
+#define MAMEPID_SIMD_SCALAR
+#endif
+
+namespace mamePID::simd {
+
+enum class Isa
+{
+  Scalar,
+  SSE2,
+  AVX2,
+  AVX512,
+};
+
+inline bool
+supported(Isa isa)
+{
+#if MAMEPID_SIMD_X86
+  switch (isa) {
+    case Isa::Scalar:
+      return true;
+    case Isa::SSE2:
+      return __builtin_cpu_supports("sse2");
+    case Isa::AVX2:
+      return __builtin_cpu_supports("avx2");
+    case Isa::AVX512:
+      return __builtin_cpu_supports("avx512f");
+  }
+  return false;
+#else
+  return isa == Isa::Scalar;
+#endif
+}
+
+inline Isa
+best()
+{
+  static const Isa isa = [] {
+    for (Isa candidate : { Isa::AVX512, Isa::AVX2, Isa::SSE2 }) {
+      if (supported(candidate)) {
+        return candidate;
+      }
+    }
+    return Isa::Scalar;
+  }();
+  return isa;
+}
+
+// Per-field arrays of a PIDBank. Fields of absent components may be null; b and c are the setpoint
+// weights of weighted banks. Filtered banks step d = a * filtered + kd * (error - pre), with kd holding
+// the b coefficient of FilteredDerivative.
+template<typename T>
+struct Lanes
+{
+  const T*                kp;
+  const accumulator_t<T>* ki;
+  const T*                kd;
+  const T*                minv;
+  const T*                maxv;
+  accumulator_t<T>*       integral;
+  T*                      pre;
+  const T*                b;
+  const T*                c;
+  const T*                a;
+  T*                      filtered;
+};
+
+template<bool PrecedingP, bool HasI, bool HasD, bool PrecedingD, bool Weighted, bool Filtered, typename T>
+MAMEPID_SIMD_SCALAR void
+step_scalar(
+  const Lanes<T>& lanes,
+  const T*        setpoints,
+  const T*        pvs,
+  T*              out,
+  std::size_t     begin,
+  std::size_t     end
+)
+{
+  MAMEPID_SIMD_NO_CONTRACT
+  for (std::size_t i = begin; i < end; ++i) {
+    const T setpoint = setpoints[i];
+    const T pv       = pvs[i];
+    const T error    = setpoint - pv;
+
+    T p;
+    if constexpr (Weighted) {
+      p = lanes.kp[i] * (lanes.b[i] * setpoint - pv);
+    } else if constexpr (PrecedingP) {
+      p = -lanes.kp[i] * pv;
+    } else {
+      p = lanes.kp[i] * error;
+    }
+
+    T in{};
+    if constexpr (HasI) {
+      using A           = accumulator_t<T>;
+      const A integral  = lanes.integral[i] + lanes.ki[i] * A(error);
+      lanes.integral[i] = std::clamp(integral, A(lanes.minv[i]), A(lanes.maxv[i]));
+      in                = T(lanes.integral[i]);
+    }
+
+    T d{};
+    if constexpr (Weighted && HasD) {
+      const T weighted = lanes.c[i] * setpoint - pv;
+      d                = lanes.kd[i] * (weighted - lanes.pre[i]);
+      lanes.pre[i]     = weighted;
+    } else if constexpr (PrecedingD && Filtered) {
+      d                 = lanes.a[i] * lanes.filtered[i] - lanes.kd[i] * (pv - lanes.pre[i]);
+      lanes.filtered[i] = d;
+      lanes.pre[i]      = pv;
+    } else if constexpr (PrecedingD) {
+      d            = -lanes.kd[i] * (pv - lanes.pre[i]);
+      lanes.pre[i] = pv;
+    } else if constexpr (HasD && Filtered) {
+      d                 = lanes.a[i] * lanes.filtered[i] + lanes.kd[i] * (error - lanes.pre[i]);
+      lanes.filtered[i] = d;
+      lanes.pre[i]      = error;
+    } else if constexpr (HasD) {
+      d            = lanes.kd[i] * (error - lanes.pre[i]);
+      lanes.pre[i] = error;
+    }
+
+    out[i] = std::clamp(p + in + d, lanes.minv[i], lanes.maxv[i]);
+  }
+}
+
+#if MAMEPID_SIMD_X86
+namespace detail {
+
+template<typename T, std::size_t Width>
+using vec [[gnu::vector_size(sizeof(T) * Width)]] = T;
+
+// Helpers take vectors by reference so that no wide vector crosses a non-AVX function boundary.
+template<typename V, typename T>
+[[gnu::always_inline]] inline void
+load(V& v, const T* p)
+{
+  std::memcpy(&v, p, sizeof(V));
+}
+
+template<typename V, typename T>
+[[gnu::always_inline]] inline void
+store(T* p, const V& v)
+{
+  std::memcpy(static_cast<void*>(p), &v, sizeof(V));
+}
+
+// Same selection order as std::clamp, including NaN propagation.
+template<typename V>
+[[gnu::always_inline]] inline void
+clamp(V& v, const V& lo, const V& hi)
+{
+  v = v < lo ? lo : (hi < v ? hi : v);
+}
+
+template<
+  bool PrecedingP,
+  bool HasI,
+  bool HasD,
+  bool PrecedingD,
+  bool Weighted,
+  bool Filtered,
+  typename V,
+  typename T>
+[[gnu::always_inline]] inline void
+step_vector(const Lanes<T>& shared, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+  MAMEPID_SIMD_NO_CONTRACT
+  constexpr std::size_t width = sizeof(V) / sizeof(T);
+
+  // A local copy lets the compiler keep the field pointers in registers across the stores below.
+  const Lanes<T> lanes = shared;
+
+  std::size_t i = 0;
+  for (; i + width <= n; i += width) {
+    V setpoint, pv, minv, maxv;
+    load(setpoint, setpoints + i);
+    load(pv, pvs + i);
+    load(minv, lanes.minv + i);
+    load(maxv, lanes.maxv + i);
+    const V error = setpoint - pv;
+
+    V p;
+    load(p, lanes.kp + i);
+    if constexpr (Weighted) {
+      V b;
+      load(b, lanes.b + i);
+      p = p * (b * setpoint - pv);
+    } else if constexpr (PrecedingP) {
+      p = -p * pv;
+    } else {
+      p = p * error;
+    }
+
+    V in{};
+    if constexpr (HasI) {
+      V ki;
+      load(ki, lanes.ki + i);
+      load(in, lanes.integral + i);
+      const V product = ki * error;
+      in              = in + product;
+      clamp(in, minv, maxv);
+      store(lanes.integral + i, in);
+    }
+
+    V d{};
+    if constexpr (HasD) {
+      V kd, pre;
+      load(kd, lanes.kd + i);
+      load(pre, lanes.pre + i);
+      if constexpr (Weighted) {
+        V c;
+        load(c, lanes.c + i);
+        const V weighted = c * setpoint - pv;
+        d                = kd * (weighted - pre);
+        store(lanes.pre + i, weighted);
+      } else if constexpr (PrecedingD && Filtered) {
+        V a, filtered;
+        load(a, lanes.a + i);
+        load(filtered, lanes.filtered + i);
+        const V decayed = a * filtered;
+        d               = decayed - kd * (pv - pre);
+        store(lanes.filtered + i, d);
+        store(lanes.pre + i, pv);
+      } else if constexpr (PrecedingD) {
+        d = -kd * (pv - pre);
+        store(lanes.pre + i, pv);
+      } else if constexpr (Filtered) {
+        V a, filtered;
+        load(a, lanes.a + i);
+        load(filtered, lanes.filtered + i);
+        const V decayed = a * filtered;
+        d               = decayed + kd * (error - pre);
+        store(lanes.filtered + i, d);
+        store(lanes.pre + i, error);
+      } else {
+        d = kd * (error - pre);
+        store(lanes.pre + i, error);
+      }
+    }
+
+    const V sum    = p + in;
+    V       output = sum + d;
+    clamp(output, minv, maxv);
+    store(out + i, output);
+  }
+  step_scalar<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(lanes, setpoints, pvs, out, i, n);
+}
+
+template<bool PrecedingP, bool HasI, bool HasD, bool PrecedingD, bool Weighted, bool Filtered, typename T>
+MAMEPID_SIMD_TARGET("sse2")
+void step_sse2(const Lanes<T>& lanes, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+  step_vector<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered, vec<T, 16 / sizeof(T)>>(
+    lanes, setpoints, pvs, out, n
+  );
+}
+
+template<bool PrecedingP, bool HasI, bool HasD, bool PrecedingD, bool Weighted, bool Filtered, typename T>
+MAMEPID_SIMD_TARGET("avx2")
+void step_avx2(const Lanes<T>& lanes, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+  step_vector<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered, vec<T, 32 / sizeof(T)>>(
+    lanes, setpoints, pvs, out, n
+  );
+}
+
+template<bool PrecedingP, bool HasI, bool HasD, bool PrecedingD, bool Weighted, bool Filtered, typename T>
+MAMEPID_SIMD_TARGET("avx512f")
+void step_avx512(const Lanes<T>& lanes, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+  step_vector<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered, vec<T, 64 / sizeof(T)>>(
+    lanes, setpoints, pvs, out, n
+  );
+}
+
+// Fixed<std::int16_t, F> banks. Values are widened to 32-bit lanes, so every lane rounds and saturates
+// exactly like the scalar Fixed operators. Banks with an integrator use half as many lanes, so that the
+// accumulator arithmetic in doubles fits a register. SSE2 lacks 32-bit multiplies and min/max, so those
+// banks stay on the scalar path there.
+template<typename T>
+inline constexpr bool fixed16 = false;
+
+template<int FracBits>
+inline constexpr bool fixed16<Fixed<std::int16_t, FracBits>> = true;
+
+template<typename V, typename T>
+[[gnu::always_inline]] inline void
+widen(V& v, const T* p)
+{
+  vec<std::int16_t, sizeof(V) / sizeof(std::int32_t)> raw;
+  std::memcpy(&raw, p, sizeof(raw));
+  v = __builtin_convertvector(raw, V);
+}
+
+template<typename V, typename T>
+[[gnu::always_inline]] inline void
+narrow(T* p, const V& v)
+{
+  const auto raw = __builtin_convertvector(v, vec<std::int16_t, sizeof(V) / sizeof(std::int32_t)>);
+  std::memcpy(static_cast<void*>(p), &raw, sizeof(raw));
+}
+
+// Rounds doubles toward negative infinity; v must be within the range of int32.
+template<typename D>
+[[gnu::always_inline]] inline void
+floor(D& v)
+{
+  using I = vec<std::int32_t, sizeof(D) / sizeof(double)>;
+  const D truncated = __builtin_convertvector(__builtin_convertvector(v, I), D);
+  v                 = v < truncated ? truncated - 1.0 : truncated;
+}
+
+// r = v clamped to the range of Int.
+template<typename Int, typename V, typename W>
+[[gnu::always_inline]] inline void
+saturate(V& r, W& v)
+{
+  clamp(v, W{} + std::numeric_limits<Int>::min(), W{} + std::numeric_limits<Int>::max());
+  r = __builtin_convertvector(v, V);
+}
+
+template<int FracBits, typename V>
+[[gnu::always_inline]] inline void
+q_mul(V& r, const V& a, const V& b)
+{
+  V product = (a * b + (1 << (FracBits - 1))) >> FracBits;
+  saturate<std::int16_t>(r, product);
+}
+
+template<typename V>
+[[gnu::always_inline]] inline void
+q_add(V& r, const V& a, const V& b)
+{
+  V sum = a + b;
+  saturate<std::int16_t>(r, sum);
+}
+
+template<typename V>
+[[gnu::always_inline]] inline void
+q_sub(V& r, const V& a, const V& b)
+{
+  V difference = a - b;
+  saturate<std::int16_t>(r, difference);
+}
+
+template<typename V>
+[[gnu::always_inline]] inline void
+q_neg(V& r, const V& a)
+{
+  V negated = -a;
+  saturate<std::int16_t>(r, negated);
+}
+
+template<
+  bool PrecedingP,
+  bool HasI,
+  bool HasD,
+  bool PrecedingD,
+  bool Weighted,
+  bool Filtered,
+  std::size_t Width,
+  typename T>
+[[gnu::always_inline]] inline void
+step_fixed16(const Lanes<T>& shared, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+  static_assert(!Filtered, "filtered banks hold floating-point values");
+  using V              = vec<std::int32_t, Width>;
+  using D              = vec<double, Width>;
+  constexpr int  frac  = T::frac_bits;
+  const Lanes<T> lanes = shared;
+
+  std::size_t i = 0;
+  for (; i + Width <= n; i += Width) {
+    V setpoint, pv, minv, maxv, error;
+    widen(setpoint, setpoints + i);
+    widen(pv, pvs + i);
+    widen(minv, lanes.minv + i);
+    widen(maxv, lanes.maxv + i);
+    q_sub(error, setpoint, pv);
+
+    V p;
+    widen(p, lanes.kp + i);
+    if constexpr (Weighted) {
+      V b, weighted;
+      widen(b, lanes.b + i);
+      q_mul<frac>(weighted, b, setpoint);
+      q_sub(weighted, weighted, pv);
+      q_mul<frac>(p, p, weighted);
+    } else if constexpr (PrecedingP) {
+      q_neg(p, p);
+      q_mul<frac>(p, p, pv);
+    } else {
+      q_mul<frac>(p, p, error);
+    }
+
+    V in{};
+    if constexpr (HasI) {
+      // The accumulator has 2 * frac fractional bits, so A(error) = error << frac and ki * A(error) rounds
+      // to (ki * error + 2^(frac - 1)) >> frac. The product stays below 2^47 and is only scaled by powers
+      // of two, so doubles hold every intermediate exactly and need no 64-bit integer multiplies.
+      V ki, integral;
+      load(ki, lanes.ki + i);
+      load(integral, lanes.integral + i);
+      const V scale = V{} + (1 << frac);
+      const D lo    = D{} + double(std::numeric_limits<std::int32_t>::min());
+      const D hi    = D{} + double(std::numeric_limits<std::int32_t>::max());
+      D       x     = __builtin_convertvector(ki, D) * __builtin_convertvector(error, D);
+      x             = (x + double(1 << (frac - 1))) * (1.0 / double(1 << frac));
+      clamp(x, lo, hi);
+      floor(x);
+      x = __builtin_convertvector(integral, D) + x;
+      clamp(x, lo, hi);
+      clamp(x, __builtin_convertvector(minv * scale, D), __builtin_convertvector(maxv * scale, D));
+      integral = __builtin_convertvector(x, V);
+      store(lanes.integral + i, integral);
+      // The clamped accumulator is within the limits, so rounding it back cannot leave the 16-bit range.
+      in = (integral + (1 << (frac - 1))) >> frac;
+    }
+
+    V d{};
+    if constexpr (HasD) {
+      V kd, pre;
+      widen(kd, lanes.kd + i);
+      widen(pre, lanes.pre + i);
+      if constexpr (Weighted) {
+        V c, weighted;
+        widen(c, lanes.c + i);
+        q_mul<frac>(weighted, c, setpoint);
+        q_sub(weighted, weighted, pv);
+        q_sub(d, weighted, pre);
+        q_mul<frac>(d, kd, d);
+        narrow(lanes.pre + i, weighted);
+      } else if constexpr (PrecedingD) {
+        q_neg(kd, kd);
+        q_sub(d, pv, pre);
+        q_mul<frac>(d, kd, d);
+        narrow(lanes.pre + i, pv);
+      } else {
+        q_sub(d, error, pre);
+        q_mul<frac>(d, kd, d);
+        narrow(lanes.pre + i, error);
+      }
+    }
+
+    V output;
+    q_add(output, p, in);
+    q_add(output, output, d);
+    clamp(output, minv, maxv);
+    narrow(out + i, output);
+  }
+  step_scalar<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(lanes, setpoints, pvs, out, i, n);
+}
+
+template<bool PrecedingP, bool HasI, bool HasD, bool PrecedingD, bool Weighted, bool Filtered, typename T>
+MAMEPID_SIMD_TARGET("avx2")
+void step_fixed16_avx2(const Lanes<T>& lanes, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+  step_fixed16<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered, HasI ? 4 : 8>(
+    lanes, setpoints, pvs, out, n
+  );
+}
+
+template<bool PrecedingP, bool HasI, bool HasD, bool PrecedingD, bool Weighted, bool Filtered, typename T>
+MAMEPID_SIMD_TARGET("avx512f")
+void step_fixed16_avx512(const Lanes<T>& lanes, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+  step_fixed16<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered, HasI ? 8 : 16>(
+    lanes, setpoints, pvs, out, n
+  );
+}
+
+} // namespace detail
+#endif
+
+// Steps n loops with the requested instruction set, falling back to scalar code when the set is not
+// supported or T is not float, double or a 16-bit Fixed (AVX2 and AVX-512 only). All paths are
+// bit-identical.
+template<bool PrecedingP, bool HasI, bool HasD, bool PrecedingD, bool Weighted, bool Filtered, typename T>
+void
+step(Isa isa, const Lanes<T>& lanes, const T* setpoints, const T* pvs, T* out, std::size_t n)
+{
+#if MAMEPID_SIMD_X86
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    if (supported(isa)) {
+      switch (isa) {
+        case Isa::SSE2:
+          return detail::step_sse2<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(
+            lanes, setpoints, pvs, out, n
+          );
+        case Isa::AVX2:
+          return detail::step_avx2<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(
+            lanes, setpoints, pvs, out, n
+          );
+        case Isa::AVX512:
+          return detail::step_avx512<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(
+            lanes, setpoints, pvs, out, n
+          );
+        case Isa::Scalar:
+          break;
+      }
+    }
+  } else if constexpr (detail::fixed16<T>) {
+    if (supported(isa)) {
+      switch (isa) {
+        case Isa::AVX2:
+          return detail::step_fixed16_avx2<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(
+            lanes, setpoints, pvs, out, n
+          );
+        case Isa::AVX512:
+          return detail::step_fixed16_avx512<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(
+            lanes, setpoints, pvs, out, n
+          );
+        case Isa::SSE2:
+        case Isa::Scalar:
+          break;
+      }
+    }
+  }
+#else
+  (void)isa;
+#endif
+  step_scalar<PrecedingP, HasI, HasD, PrecedingD, Weighted, Filtered>(lanes, setpoints, pvs, out, 0, n);
+}
+
+} // namespace mamePID::simd
+
+#endif // MAMEPID_SIMD_HPP_
@@ -0,0 +1,295 @@
+#ifndef MAMEPID_SIMULATION_HPP_
+#define MAMEPID_SIMULATION_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/bank.hpp>
+
+namespace mamePID {
+
+// Discrete plant model sampled every dt:
+//   y[k] = (b[0] u[k - delay] + ... + b[m] u[k - delay - m] - a[1] y[k - 1] - ... - a[m] y[k - m]) / a[0]
+// u[k] is held during sample k and y[k] is the output at its end, so a controller that reads y[k - 1]
+// and writes u[k] closes the loop without an extra sample of delay.
+template<std::floating_point T>
+class TransferFunction
+{
+public:
+  TransferFunction(std::vector<T> numerator, std::vector<T> denominator, T dt, std::size_t delay = 0)
+    : b(std::move(numerator))
+    , a(std::move(denominator))
+    , period(dt)
+    , dead_time(delay)
+  {
+    assert(!a.empty() && a[0] != T(0) && !b.empty());
+    const std::size_t order = std::max(a.size(), b.size()) - 1;
+    b.resize(order + 1, T(0));
+    a.resize(order + 1, T(0));
+    const T a0 = a[0];
+    for (std::size_t j = 0; j <= order; ++j) {
+      b[j] /= a0;
+      a[j] /= a0;
+    }
+  }
+
+  std::span<const T> numerator() const { return b; }
+  std::span<const T> denominator() const { return a; }
+  std::size_t        order() const { return a.size() - 1; }
+  T                  dt() const { return period; }
+  std::size_t        delay() const { return dead_time; }
+
+private:
+  std::vector<T> b;
+  std::vector<T> a;
+  T              period;
+  std::size_t    dead_time;
+};
+
+// K exp(-theta s) / (tau s + 1), discretized exactly for an input held over each sample. The dead time
+// is rounded to whole samples.
+template<std::floating_point T>
+TransferFunction<T>
+first_order_dead_time(T gain, T tau, T theta, T dt)
+{
+  const T pole = std::exp(-dt / tau);
+  return TransferFunction<T>(
+    { gain * (T(1) - pole) }, { T(1), -pole }, dt, static_cast<std::size_t>(std::lround(theta / dt))
+  );
+}
+
+// K wn^2 / (s^2 + 2 zeta wn s + wn^2), discretized with the bilinear transform.
+template<std::floating_point T>
+TransferFunction<T>
+second_order(T gain, T wn, T zeta, T dt)
+{
+  const T c  = T(2) / dt;
+  const T w2 = wn * wn;
+  const T k  = gain * w2;
+  const T d  = T(2) * zeta * wn * c;
+  return TransferFunction<T>({ k, T(2) * k, k }, { c * c + d + w2, T(2) * (w2 - c * c), c * c - d + w2 }, dt);
+}
+
+// n independent copies of one plant, stepped together. States are stored per delay and per order with the
+// copies contiguous, so every update is a plain loop over the copies.
+template<std::floating_point T>
+class PlantBank
+{
+public:
+  PlantBank(const TransferFunction<T>& model, std::size_t n)
+    : b(model.numerator().begin(), model.numerator().end())
+    , a(model.denominator().begin(), model.denominator().end())
+    , count(n)
+    , state(model.order() * n)
+    , history(model.delay() * n)
+    , delayed(n)
+  {
+  }
+
+  std::size_t size() const { return count; }
+
+  void reset()
+  {
+    std::fill(state.begin(), state.end(), T(0));
+    std::fill(history.begin(), history.end(), T(0));
+    head = 0;
+  }
+
+  // Feeds u[i] to copy i and writes its new output to y[i].
+  void step(std::span<const T> u, std::span<T> y)
+  {
+    assert(u.size() == count && y.size() == count);
+
+    const T* input = u.data();
+    if (!history.empty()) {
+      T* slot = history.data() + head * count;
+      for (std::size_t i = 0; i < count; ++i) {
+        delayed[i] = slot[i];
+        slot[i]    = u[i];
+      }
+      head  = head + 1 == history.size() / count ? 0 : head + 1;
+      input = delayed.data();
+    }
+
+    // Transposed direct form II.
+    const std::size_t order = a.size() - 1;
+    if (order == 0) {
+      for (std::size_t i = 0; i < count; ++i) {
+        y[i] = b[0] * input[i];
+      }
+      return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      y[i] = b[0] * input[i] + state[i];
+    }
+    for (std::size_t j = 0; j + 1 < order; ++j) {
+      T*       s    = state.data() + j * count;
+      const T* next = s + count;
+      for (std::size_t i = 0; i < count; ++i) {
+        s[i] = b[j + 1] * input[i] - a[j + 1] * y[i] + next[i];
+      }
+    }
+    T* last = state.data() + (order - 1) * count;
+    for (std::size_t i = 0; i < count; ++i) {
+      last[i] = b[order] * input[i] - a[order] * y[i];
+    }
+  }
+
+private:
+  std::vector<T> b;
+  std::vector<T> a;
+  std::size_t    count;
+  std::vector<T> state;
+  std::vector<T> history;
+  std::vector<T> delayed;
+  std::size_t    head = 0;
+};
+
+// Step-response cost of one candidate. Overshoot is relative to the setpoint; settling time is the
+// first time after which the output stays within the band, or infinity if it never does.
+template<typename T>
+struct Cost
+{
+  T iae;
+  T ise;
+  T itae;
+  T overshoot;
+  T settling_time;
+};
+
+template<typename T>
+struct SweepOptions
+{
+  T           setpoint = T(1);
+  std::size_t steps    = 1000;
+  T           min      = std::numeric_limits<T>::lowest();
+  T           max      = std::numeric_limits<T>::max();
+  // Settling band as a fraction of the setpoint.
+  T band = T(0.02);
+  // Number of threads; 0 uses std::thread::hardware_concurrency().
+  std::size_t threads = 0;
+  // Candidates stepped together as one bank. Smaller blocks spread small sweeps over more threads.
+  std::size_t block = 256;
+};
+
+namespace detail {
+
+template<typename T, typename MakeBank>
+void
+sweep_range(
+  std::span<const Gains<T>>  candidates,
+  const TransferFunction<T>& model,
+  const SweepOptions<T>&     options,
+  MakeBank&                  make_bank,
+  std::span<Cost<T>>         costs
+)
+{
+  const std::size_t n    = candidates.size();
+  auto              bank = make_bank(n);
+  for (const auto& gains : candidates) {
+    bank.push_back(gains, model.dt(), options.min, options.max);
+  }
+  PlantBank<T> plant(model, n);
+
+  const T        dt        = model.dt();
+  const T        sp        = options.setpoint;
+  const T        direction = sp < T(0) ? T(-1) : T(1);
+  const T        band      = options.band * std::abs(sp);
+  std::vector<T> setpoints(n, sp), u(n), y(n, T(0));
+  std::vector<T> iae(n, T(0)), ise(n, T(0)), itae(n, T(0)), peak(n, T(0)), settled(n, T(0));
+
+  for (std::size_t k = 0; k < options.steps; ++k) {
+    bank.calculate(setpoints, y, u);
+    plant.step(u, y);
+    const T t = T(k + 1) * dt;
+    for (std::size_t i = 0; i < n; ++i) {
+      const T e     = sp - y[i];
+      const T abs_e = std::abs(e);
+      iae[i] += abs_e * dt;
+      ise[i] += e * e * dt;
+      itae[i] += t * abs_e * dt;
+      peak[i]    = std::max(peak[i], -e * direction);
+      settled[i] = band < abs_e ? t : settled[i];
+    }
+  }
+
+  const T end = T(options.steps) * dt;
+  for (std::size_t i = 0; i < n; ++i) {
+    costs[i] = { iae[i],
+                 ise[i],
+                 itae[i],
+                 sp == T(0) ? peak[i] : peak[i] / std::abs(sp),
+                 settled[i] < end ? settled[i] : std::numeric_limits<T>::infinity() };
+  }
+}
+
+} // namespace detail
+
+// Closed-loop step responses of every candidate against model, starting from rest. Candidates are stepped
+// in blocks small enough for the controller, plant and cost state to stay in cache for the whole run; each
+// block is one bank built by make_bank(capacity), e.g. pid_bank<T> or i_pd_bank<T>, and the threads take
+// blocks in turn. Costs are accumulated while stepping, so memory use does not grow with options.steps.
+template<std::floating_point T, typename MakeBank>
+std::vector<Cost<T>>
+sweep(
+  std::span<const Gains<std::type_identity_t<T>>> candidates,
+  const TransferFunction<T>&                      model,
+  const SweepOptions<T>&                          options,
+  MakeBank                                        make_bank
+)
+{
+  const std::size_t        block  = std::max<std::size_t>(1, options.block);
+  const std::size_t        blocks = (candidates.size() + block - 1) / block;
+  std::vector<Cost<T>>     costs(candidates.size());
+  std::atomic<std::size_t> next{ 0 };
+  const auto               work = [&] {
+    for (std::size_t b = next++; b < blocks; b = next++) {
+      const std::size_t begin = b * block;
+      const std::size_t count = std::min(block, candidates.size() - begin);
+      detail::sweep_range(
+        candidates.subspan(begin, count), model, options, make_bank, std::span(costs).subspan(begin, count)
+      );
+    }
+  };
+
+  const std::size_t hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  const std::size_t threads  = std::min(options.threads == 0 ? hardware : options.threads, blocks);
+  if (threads <= 1) {
+    work();
+    return costs;
+  }
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return costs;
+}
+
+template<std::floating_point T>
+std::vector<Cost<T>>
+sweep(
+  std::span<const Gains<std::type_identity_t<T>>> candidates,
+  const TransferFunction<T>&                      model,
+  const SweepOptions<T>&                          options
+)
+{
+  return sweep(candidates, model, options, [](std::size_t capacity) { return pid_bank<T>(capacity); });
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_SIMULATION_HPP_
@@ -0,0 +1,94 @@
+#ifndef MAMEPID_SPSC_HPP_
+#define MAMEPID_SPSC_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+#include <mamePID/aligned.hpp>
+
+namespace mamePID {
+
+// Bounded wait-free queue for exactly one producer thread and one consumer thread.
+// Both ends keep a cached copy of the other end's index, so the shared indices are only read when the
+// queue looks full or empty.
+template<typename T, std::size_t Capacity>
+  requires std::is_trivially_copyable_v<T> && (0 < Capacity) && ((Capacity & (Capacity - 1)) == 0)
+class SpscRing
+{
+public:
+  using value_type = T;
+
+  static constexpr std::size_t capacity() { return Capacity; }
+
+  // Producer side. Returns false and drops the value when the ring is full.
+  bool try_push(const T& value)
+  {
+    const std::size_t tail = producer.tail;
+    if (tail - producer.head == Capacity) {
+      producer.head = head.load(std::memory_order_acquire);
+      if (tail - producer.head == Capacity) {
+        return false;
+      }
+    }
+    slots[tail & mask] = value;
+    producer.tail      = tail + 1;
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side.
+  std::optional<T> try_pop()
+  {
+    const std::size_t head = consumer.head;
+    if (head == consumer.tail) {
+      consumer.tail = tail.load(std::memory_order_acquire);
+      if (head == consumer.tail) {
+        return std::nullopt;
+      }
+    }
+    const T value = slots[head & mask];
+    consumer.head = head + 1;
+    this->head.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  // Pops everything that is available and returns how many values were passed to f.
+  template<typename F>
+  std::size_t drain(F&& f)
+  {
+    std::size_t n = 0;
+    while (const auto value = try_pop()) {
+      f(*value);
+      ++n;
+    }
+    return n;
+  }
+
+  // Approximate when called concurrently with either side.
+  std::size_t size() const
+  {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr std::size_t mask = Capacity - 1;
+
+  struct Cursor
+  {
+    std::size_t head = 0;
+    std::size_t tail = 0;
+  };
+
+  alignas(detail::cache_line) std::atomic<std::size_t> head{ 0 };
+  alignas(detail::cache_line) std::atomic<std::size_t> tail{ 0 };
+  alignas(detail::cache_line) Cursor producer;
+  alignas(detail::cache_line) Cursor consumer;
+  alignas(detail::cache_line) std::array<T, Capacity> slots;
+};
+
+} // namespace mamePID
+
+#endif // MAMEPID_SPSC_HPP_
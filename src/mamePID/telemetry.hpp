@@ -0,0 +1,116 @@
+#ifndef MAMEPID_TELEMETRY_HPP_
+#define MAMEPID_TELEMETRY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <mamePID.hpp>
+#include <mamePID/spsc.hpp>
+
+namespace mamePID {
+
+// Bits of Sample::saturation.
+struct Saturation
+{
+  static constexpr std::uint8_t output_low  = 1 << 0;
+  static constexpr std::uint8_t output_high = 1 << 1;
+  static constexpr std::uint8_t integral    = 1 << 2;
+};
+
+// One controller update as recorded by Traced.
+template<typename T>
+struct Sample
+{
+  std::int64_t timestamp;
+  T            setpoint;
+  T            pv;
+  T            p;
+  T            i;
+  T            d;
+  T            unclamped;
+  T            output;
+  std::uint8_t saturation;
+};
+
+template<typename T, std::size_t Capacity>
+using TelemetryRing = SpscRing<Sample<T>, Capacity>;
+
+template<typename ControllerT>
+concept Traceable = requires(ControllerT controller, typename ControllerT::value_type v) {
+  { controller.calculate_terms(v, v) } -> std::same_as<Terms<typename ControllerT::value_type>>;
+  { controller.integral_saturated() } -> std::convertible_to<bool>;
+};
+
+// Records every update of the wrapped controller into a ring that another thread drains. The control
+// thread never waits: when the ring is full the sample is dropped and counted. Controllers that are not
+// wrapped pay nothing.
+// Clock::now() supplies the timestamp in Clock::duration ticks; substitute a cheaper clock, e.g. a cycle
+// or tick counter, where steady_clock is too slow.
+template<Traceable ControllerT, std::size_t Capacity, typename Clock = std::chrono::steady_clock>
+class Traced
+{
+public:
+  using value_type = typename ControllerT::value_type;
+  using ring_type  = TelemetryRing<value_type, Capacity>;
+
+  Traced(ControllerT controller, ring_type& ring)
+    : controller(std::move(controller))
+    , ring(&ring)
+  {
+  }
+
+  value_type calculate(value_type setpoint, value_type pv)
+  {
+    const auto   terms      = controller.calculate_terms(setpoint, pv);
+    std::uint8_t saturation = 0;
+    if (terms.unclamped < controller.min()) {
+      saturation |= Saturation::output_low;
+    }
+    if (controller.max() < terms.unclamped) {
+      saturation |= Saturation::output_high;
+    }
+    if (controller.integral_saturated()) {
+      saturation |= Saturation::integral;
+    }
+
+    const Sample<value_type> sample{ Clock::now().time_since_epoch().count(),
+                                     setpoint,
+                                     pv,
+                                     terms.p,
+                                     terms.i,
+                                     terms.d,
+                                     terms.unclamped,
+                                     terms.output,
+                                     saturation };
+    if (!ring->try_push(sample)) {
+      dropped_samples.store(dropped_samples.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    return terms.output;
+  }
+
+  // Number of samples lost to a full ring. May be read from any thread.
+  std::size_t dropped() const { return dropped_samples.load(std::memory_order_relaxed); }
+
+  ControllerT&       get() { return controller; }
+  const ControllerT& get() const { return controller; }
+
+private:
+  ControllerT              controller;
+  ring_type*               ring;
+  std::atomic<std::size_t> dropped_samples{ 0 };
+};
+
+template<typename Clock = std::chrono::steady_clock, typename ControllerT, std::size_t Capacity>
+auto
+traced(ControllerT controller, TelemetryRing<typename ControllerT::value_type, Capacity>& ring)
+{
+  return Traced<ControllerT, Capacity, Clock>(std::move(controller), ring);
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_TELEMETRY_HPP_
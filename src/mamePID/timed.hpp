@@ -0,0 +1,71 @@
+#ifndef MAMEPID_TIMED_HPP_
+#define MAMEPID_TIMED_HPP_
+
+#include <chrono>
+#include <concepts>
+#include <optional>
+#include <utility>
+
+#include <mamePID.hpp>
+
+namespace mamePID {
+
+template<typename C>
+concept VariableStepController = requires(C c, typename C::value_type v) {
+  { c.calculate(v, v) } -> std::convertible_to<typename C::value_type>;
+  { c.calculate(v, v, v) } -> std::convertible_to<typename C::value_type>;
+};
+
+// Steps a controller with the time elapsed since its previous update, taken from the time points the
+// samples were measured at. The first update uses the controller's nominal sampling period. A sample
+// that is not later than the previous one returns the previous output without stepping the controller.
+template<VariableStepController ControllerT, typename Clock = std::chrono::steady_clock>
+class Timed
+{
+public:
+  using value_type = typename ControllerT::value_type;
+  using time_point = typename Clock::time_point;
+
+  explicit Timed(ControllerT controller)
+    : controller(std::move(controller))
+  {
+  }
+
+  value_type calculate(value_type setpoint, value_type pv, time_point now)
+  {
+    if (!last) {
+      output = controller.calculate(setpoint, pv);
+    } else if (*last < now) {
+      const std::chrono::duration<double> dt = now - *last;
+      output                                 = controller.calculate(setpoint, pv, value_type(dt.count()));
+    } else {
+      return output;
+    }
+    last = now;
+    return output;
+  }
+
+  value_type calculate(value_type setpoint, value_type pv) { return calculate(setpoint, pv, Clock::now()); }
+
+  // Forgets the previous time point, e.g. after the loop was paused.
+  void restart() { last.reset(); }
+
+  ControllerT&       get() { return controller; }
+  const ControllerT& get() const { return controller; }
+
+private:
+  ControllerT               controller;
+  std::optional<time_point> last;
+  value_type                output{};
+};
+
+template<typename Clock = std::chrono::steady_clock, VariableStepController ControllerT>
+auto
+timed(ControllerT controller)
+{
+  return Timed<ControllerT, Clock>(std::move(controller));
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_TIMED_HPP_
@@ -0,0 +1,306 @@
+#ifndef MAMEPID_TRACE_HPP_
+#define MAMEPID_TRACE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <mamePID.hpp>
+
+namespace mamePID {
+
+enum class Architecture : std::uint32_t
+{
+  PID  = 0,
+  PI_D = 1,
+  I_PD = 2,
+};
+
+// On-disk layout, native little-endian:
+//   TraceHeader
+//   blocks of header.block_size samples (the last one may be shorter), each holding the setpoint, pv and
+//   output columns back to back. Every column is padded to a multiple of 8 bytes.
+struct TraceHeader
+{
+  std::array<char, 8> magic;
+  std::uint32_t       version;
+  Architecture        architecture;
+  std::uint32_t       value_size;
+  std::uint32_t       block_size;
+  double              kp;
+  double              ki;
+  double              kd;
+  double              dt;
+  double              min;
+  double              max;
+  std::uint64_t       samples;
+};
+
+static_assert(sizeof(TraceHeader) == 80);
+static_assert(std::endian::native == std::endian::little);
+
+inline constexpr std::array<char, 8> trace_magic   = { 'm', 'a', 'm', 'e', 'P', 'I', 'D', 'T' };
+inline constexpr std::uint32_t       trace_version = 1;
+
+namespace detail {
+
+constexpr std::size_t
+trace_column_bytes(std::size_t count, std::size_t value_size)
+{
+  return (count * value_size + 7) / 8 * 8;
+}
+
+} // namespace detail
+
+template<std::floating_point T>
+class TraceWriter
+{
+public:
+  TraceWriter(
+    const std::string& path,
+    Architecture       architecture,
+    const Gains<T>&    gains,
+    T                  dt,
+    T                  min        = std::numeric_limits<T>::lowest(),
+    T                  max        = std::numeric_limits<T>::max(),
+    std::uint32_t      block_size = 4096
+  )
+    : file(path, std::ios::binary | std::ios::trunc)
+    , header{ trace_magic,
+              trace_version,
+              architecture,
+              sizeof(T),
+              block_size,
+              double(gains.kp),
+              double(gains.ki),
+              double(gains.kd),
+              double(dt),
+              double(min),
+              double(max),
+              0 }
+  {
+    if (architecture > Architecture::I_PD) {
+      throw std::invalid_argument("mamePID: unknown controller architecture");
+    }
+    if (!file || block_size == 0) {
+      throw std::runtime_error("mamePID: cannot create trace " + path);
+    }
+    setpoints.reserve(block_size);
+    pvs.reserve(block_size);
+    outputs.reserve(block_size);
+    write_header();
+  }
+
+  TraceWriter(const TraceWriter&)            = delete;
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  ~TraceWriter()
+  {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  void write(T setpoint, T pv, T output)
+  {
+    setpoints.push_back(setpoint);
+    pvs.push_back(pv);
+    outputs.push_back(output);
+    if (setpoints.size() == header.block_size) {
+      flush_block();
+    }
+  }
+
+  // Writes the pending partial block and the final sample count. Called by the destructor.
+  void close()
+  {
+    if (!file.is_open()) {
+      return;
+    }
+    flush_block();
+    write_header();
+    file.close();
+    if (file.fail()) {
+      throw std::runtime_error("mamePID: failed to write trace");
+    }
+  }
+
+private:
+  void write_header()
+  {
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.seekp(0, std::ios::end);
+  }
+
+  void write_column(const std::vector<T>& column)
+  {
+    static constexpr std::array<char, 8> padding{};
+    const std::size_t                    bytes = column.size() * sizeof(T);
+    file.write(reinterpret_cast<const char*>(column.data()), bytes);
+    file.write(padding.data(), detail::trace_column_bytes(column.size(), sizeof(T)) - bytes);
+  }
+
+  void flush_block()
+  {
+    if (setpoints.empty()) {
+      return;
+    }
+    write_column(setpoints);
+    write_column(pvs);
+    write_column(outputs);
+    header.samples += setpoints.size();
+    setpoints.clear();
+    pvs.clear();
+    outputs.clear();
+    if (!file) {
+      throw std::runtime_error("mamePID: failed to write trace");
+    }
+  }
+
+  std::ofstream  file;
+  TraceHeader    header;
+  std::vector<T> setpoints;
+  std::vector<T> pvs;
+  std::vector<T> outputs;
+};
+
+template<typename T>
+struct TraceBlock
+{
+  std::span<const T> setpoints;
+  std::span<const T> pvs;
+  std::span<const T> outputs;
+
+  std::size_t size() const { return setpoints.size(); }
+};
+
+// Read-only view of a trace file through mmap. Blocks point straight into the mapping.
+template<std::floating_point T>
+class TraceReader
+{
+public:
+  explicit TraceReader(const std::string& path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "mamePID: cannot open trace " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(TraceHeader))) {
+      ::close(fd);
+      throw std::runtime_error("mamePID: not a trace file " + path);
+    }
+    length = static_cast<std::size_t>(st.st_size);
+    data   = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "mamePID: cannot map trace " + path);
+    }
+    ::madvise(data, length, MADV_SEQUENTIAL);
+
+    // Every sample takes at least three values, so a sample count within that bound cannot overflow
+    // bytes_before().
+    std::memcpy(&info, data, sizeof(info));
+    if (info.magic != trace_magic || info.version != trace_version || info.value_size != sizeof(T) ||
+        info.architecture > Architecture::I_PD || info.block_size == 0 ||
+        info.samples > (length - sizeof(TraceHeader)) / (3 * sizeof(T)) ||
+        length < sizeof(TraceHeader) + bytes_before(info.samples)) {
+      ::munmap(data, length);
+      throw std::runtime_error("mamePID: invalid or truncated trace " + path);
+    }
+  }
+
+  TraceReader(const TraceReader&)            = delete;
+  TraceReader& operator=(const TraceReader&) = delete;
+
+  ~TraceReader() { ::munmap(data, length); }
+
+  const TraceHeader& header() const { return info; }
+  std::size_t        size() const { return info.samples; }
+  std::size_t        blocks() const { return (info.samples + info.block_size - 1) / info.block_size; }
+
+  TraceBlock<T> block(std::size_t i) const
+  {
+    assert(i < blocks());
+    const std::size_t first  = i * info.block_size;
+    const std::size_t count  = std::min<std::size_t>(info.block_size, info.samples - first);
+    const std::size_t stride = detail::trace_column_bytes(count, sizeof(T));
+    const auto* base = static_cast<const std::byte*>(data) + sizeof(TraceHeader) + bytes_before(first);
+    return { { reinterpret_cast<const T*>(base), count },
+             { reinterpret_cast<const T*>(base + stride), count },
+             { reinterpret_cast<const T*>(base + 2 * stride), count } };
+  }
+
+private:
+  // Size of the blocks holding the first n samples, where n is a multiple of the block size or the total.
+  std::size_t bytes_before(std::size_t n) const
+  {
+    const std::size_t full = n / info.block_size;
+    const std::size_t rest = n % info.block_size;
+    return 3 * (full * detail::trace_column_bytes(info.block_size, sizeof(T)) +
+                detail::trace_column_bytes(rest, sizeof(T)));
+  }
+
+  void*       data   = nullptr;
+  std::size_t length = 0;
+  TraceHeader info;
+};
+
+// Calls f with the controller described by a trace header.
+template<typename T, typename F>
+decltype(auto)
+visit_controller(const TraceHeader& header, F&& f)
+{
+  const T kp = T(header.kp), ki = T(header.ki), kd = T(header.kd), dt = T(header.dt);
+  const T min = T(header.min), max = T(header.max);
+  switch (header.architecture) {
+    case Architecture::PI_D:
+      return f(pi_d(kp, ki, kd, dt, min, max));
+    case Architecture::I_PD:
+      return f(i_pd(kp, ki, kd, dt, min, max));
+    case Architecture::PID:
+      return f(pid(kp, ki, kd, dt, min, max));
+  }
+  throw std::invalid_argument("mamePID: unknown controller architecture");
+}
+
+// Steps the controller described by the trace header over the recorded setpoints and pvs, block by block,
+// and calls f(block, outputs) with the replayed outputs of each block.
+template<typename T, typename F>
+void
+replay(const TraceReader<T>& trace, F&& f)
+{
+  visit_controller<T>(trace.header(), [&](auto controller) {
+    std::vector<T> outputs(trace.header().block_size);
+    for (std::size_t i = 0; i < trace.blocks(); ++i) {
+      const auto block = trace.block(i);
+      const auto out   = std::span(outputs).first(block.size());
+      controller.run(block.setpoints, block.pvs, out);
+      f(block, std::span<const T>(out));
+    }
+  });
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_TRACE_HPP_
@@ -0,0 +1,370 @@
+#ifndef MAMEPID_TUNE_HPP_
+#define MAMEPID_TUNE_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/bank.hpp>
+#include <mamePID/simulation.hpp>
+
+namespace mamePID {
+
+// Gain and period of the sustained oscillation at the stability limit.
+template<typename T>
+struct Ultimate
+{
+  T gain;
+  T period;
+};
+
+// K exp(-theta s) / (tau s + 1).
+template<typename T>
+struct Fopdt
+{
+  T gain;
+  T tau;
+  T theta;
+
+  TransferFunction<T> model(T dt) const { return first_order_dead_time(gain, tau, theta, dt); }
+};
+
+// Ultimate gain and period from the output y of a relay experiment with the given relay amplitude and
+// hysteresis, sampled every dt. The first half of y is treated as the transient and ignored. The gain uses
+// the fundamental of the oscillation rather than its peak, which matters for waveforms far from a sine.
+// Throws std::runtime_error when the tail holds less than one period of oscillation or its amplitude does
+// not exceed the hysteresis.
+template<std::floating_point T>
+Ultimate<T>
+ultimate_from_relay(std::span<const T> y, T amplitude, T hysteresis, T dt)
+{
+  const auto tail = y.subspan(y.size() / 2);
+  const auto [low, high] = std::minmax_element(tail.begin(), tail.end());
+  const T    center      = (*low + *high) / T(2);
+
+  // Upward crossings of the center, interpolated between samples.
+  T           first = 0, last = 0;
+  std::size_t crossings = 0;
+  for (std::size_t k = 1; k < tail.size(); ++k) {
+    if (tail[k - 1] < center && center <= tail[k]) {
+      const T t = T(k - 1) + (center - tail[k - 1]) / (tail[k] - tail[k - 1]);
+      first     = crossings == 0 ? t : first;
+      last      = t;
+      ++crossings;
+    }
+  }
+  if (crossings < 2) {
+    throw std::runtime_error("mamePID: relay experiment did not oscillate");
+  }
+  const T period = (last - first) / T(crossings - 1);
+
+  // Fundamental over the whole periods between the first and the last crossing.
+  const T           w     = T(2) * std::numbers::pi_v<T> / period;
+  const std::size_t begin = static_cast<std::size_t>(std::ceil(first));
+  const std::size_t end   = static_cast<std::size_t>(std::ceil(last));
+  T                 c = 0, s = 0;
+  for (std::size_t k = begin; k < end; ++k) {
+    c += (tail[k] - center) * std::cos(w * T(k));
+    s += (tail[k] - center) * std::sin(w * T(k));
+  }
+  const T a = T(2) * std::hypot(c, s) / T(end - begin);
+  if (!(std::abs(hysteresis) < a)) {
+    throw std::runtime_error("mamePID: relay oscillation does not exceed the hysteresis");
+  }
+  const T gain = T(4) * amplitude / (std::numbers::pi_v<T> * std::sqrt(a * a - hysteresis * hysteresis));
+  return { gain, period * dt };
+}
+
+// Relay feedback experiment around an operating point: process(u) applies u for one sample and returns the
+// deviation of the process value from the operating point.
+template<std::floating_point T, std::invocable<T> Process>
+  requires std::convertible_to<std::invoke_result_t<Process&, T>, T>
+Ultimate<T>
+relay_feedback(Process&& process, T amplitude, T hysteresis, T dt, std::size_t steps)
+{
+  std::vector<T> y(steps);
+  T              u  = amplitude;
+  T              pv = 0;
+  for (std::size_t k = 0; k < steps; ++k) {
+    if (pv < -hysteresis) {
+      u = amplitude;
+    } else if (hysteresis < pv) {
+      u = -amplitude;
+    }
+    pv   = std::invoke(process, u);
+    y[k] = pv;
+  }
+  return ultimate_from_relay(std::span<const T>(y), amplitude, hysteresis, dt);
+}
+
+// First-order plus dead time fit of a recorded open-loop step response by the two-point method.
+// y[0] is the output when an input step of the given size is applied and y[k] the output k samples later;
+// the last 5% of y are averaged as the final value.
+template<std::floating_point T>
+Fopdt<T>
+identify_step(std::span<const T> y, T step, T dt)
+{
+  assert(1 < y.size());
+  const std::size_t settled = std::max<std::size_t>(1, y.size() / 20);
+  T                 final   = 0;
+  for (auto v : y.last(settled)) {
+    final += v;
+  }
+  final /= T(settled);
+  const T change = final - y.front();
+
+  const auto crossing = [&](T fraction) {
+    const T target = y.front() + fraction * change;
+    for (std::size_t k = 1; k < y.size(); ++k) {
+      if (0 <= (y[k] - target) * change) {
+        return (T(k - 1) + (target - y[k - 1]) / (y[k] - y[k - 1])) * dt;
+      }
+    }
+    return T(y.size() - 1) * dt;
+  };
+  const T t28 = crossing(T(0.283));
+  const T t63 = crossing(T(0.632));
+  const T tau = T(1.5) * (t63 - t28);
+  return { change / step, tau, std::max(T(0), t63 - tau) };
+}
+
+// Classic Ziegler-Nichols settings from the ultimate gain and period.
+template<typename T>
+Gains<T>
+ziegler_nichols(const Ultimate<T>& ultimate)
+{
+  const T kp = T(0.6) * ultimate.gain;
+  return { kp, kp / (ultimate.period / T(2)), kp * ultimate.period / T(8) };
+}
+
+template<typename T>
+Gains<T>
+ziegler_nichols_pi(const Ultimate<T>& ultimate)
+{
+  const T kp = T(0.45) * ultimate.gain;
+  return { kp, kp / (ultimate.period / T(1.2)), T(0) };
+}
+
+// Internal model control settings for a first-order plus dead time model, with closed-loop time
+// constant lambda.
+template<typename T>
+Gains<T>
+imc(const Fopdt<T>& model, T lambda)
+{
+  const T kp = (T(2) * model.tau + model.theta) / (model.gain * (T(2) * lambda + model.theta));
+  const T ti = model.tau + model.theta / T(2);
+  const T td = model.tau * model.theta / (T(2) * model.tau + model.theta);
+  return { kp, kp / ti, kp * td };
+}
+
+// Skogestad's SIMC PI rule.
+template<typename T>
+Gains<T>
+imc_pi(const Fopdt<T>& model, T lambda)
+{
+  const T kp = model.tau / (model.gain * (lambda + model.theta));
+  const T ti = std::min(model.tau, T(4) * (lambda + model.theta));
+  return { kp, kp / ti, T(0) };
+}
+
+enum class Objective
+{
+  IAE,
+  ISE,
+  ITAE,
+};
+
+template<typename T>
+struct TuneOptions
+{
+  SweepOptions<T> simulation{};
+  Objective       objective = Objective::ITAE;
+  // Candidates that overshoot by more than this fraction of the setpoint are rejected.
+  T max_overshoot = std::numeric_limits<T>::infinity();
+  // Maximum number of search iterations.
+  std::size_t iterations = 50;
+  // Initial factor every gain is multiplied or divided by when probing neighbours.
+  T step = T(2);
+  // A search stops once its factor is below 1 + tolerance.
+  T tolerance = T(0.01);
+};
+
+template<typename T>
+struct TuneResult
+{
+  Gains<T>    gains;
+  Cost<T>     cost;
+  T           objective;
+  std::size_t evaluations;
+};
+
+namespace detail {
+
+template<typename T>
+T&
+gain(Gains<T>& gains, std::size_t axis)
+{
+  return axis == 0 ? gains.kp : (axis == 1 ? gains.ki : gains.kd);
+}
+
+template<typename T>
+T
+score(const Cost<T>& cost, const TuneOptions<T>& options)
+{
+  const T value = options.objective == Objective::IAE   ? cost.iae
+                  : options.objective == Objective::ISE ? cost.ise
+                                                        : cost.itae;
+  if (!std::isfinite(value) || !(cost.overshoot <= options.max_overshoot)) {
+    return std::numeric_limits<T>::infinity();
+  }
+  return value;
+}
+
+} // namespace detail
+
+// Refines initial gains by pattern search over simulated step responses against model. Every gain is
+// searched on a logarithmic scale, so zero gains stay zero and a PI stays a PI. Searches start from every
+// combination of the initial gains multiplied by 1 / step, 1 and step, and run in lockstep: each iteration
+// simulates all neighbours of all unfinished searches as one sweep, spread over all threads. A search
+// moves to its best neighbour if that improves the objective and halves its step otherwise.
+// make_bank selects the architecture, e.g. pid_bank<T>, pi_d_bank<T> or i_pd_bank<T>.
+template<std::floating_point T, typename MakeBank>
+TuneResult<T>
+refine(
+  const Gains<std::type_identity_t<T>>& initial,
+  const TransferFunction<T>&            model,
+  const TuneOptions<T>&                 options,
+  MakeBank                              make_bank
+)
+{
+  Gains<T>                 start = initial;
+  std::vector<std::size_t> axes;
+  for (std::size_t axis = 0; axis < 3; ++axis) {
+    if (detail::gain(start, axis) != T(0)) {
+      axes.push_back(axis);
+    }
+  }
+  // All points of {-1, 0, 1}^axes; the centre is offsets[0].
+  std::vector<std::vector<int>> offsets{ std::vector<int>(axes.size(), 0) };
+  for (std::size_t i = 0; i < axes.size(); ++i) {
+    const std::size_t count = offsets.size();
+    for (std::size_t j = 0; j < count; ++j) {
+      for (int o : { -1, 1 }) {
+        offsets.push_back(offsets[j]);
+        offsets.back()[i] = o;
+      }
+    }
+  }
+  const auto shifted = [&](Gains<T> gains, const std::vector<int>& offset, T log_step) {
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+      detail::gain(gains, axes[i]) *= std::exp(T(offset[i]) * log_step);
+    }
+    return gains;
+  };
+
+  struct Search
+  {
+    Gains<T> gains;
+    Cost<T>  cost;
+    T        objective;
+    T        log_step;
+  };
+  const T             log_step = std::log(options.step);
+  const T             min_step = std::log1p(options.tolerance);
+  std::vector<Search> searches;
+  for (const auto& offset : offsets) {
+    searches.push_back({ shifted(start, offset, log_step), {}, T(0), log_step });
+  }
+
+  // Small batches are cut into smaller blocks, so that every thread gets some.
+  const std::size_t hardware   = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  const std::size_t threads    = options.simulation.threads == 0 ? hardware : options.simulation.threads;
+  SweepOptions<T>   simulation = options.simulation;
+
+  std::size_t           evaluations = 0;
+  std::vector<Gains<T>> batch;
+  const auto            evaluate = [&] {
+    simulation.block = std::clamp<std::size_t>(
+      batch.size() / threads, 16, std::max<std::size_t>(16, options.simulation.block)
+    );
+    evaluations += batch.size();
+    return sweep(std::span<const Gains<T>>(batch), model, simulation, make_bank);
+  };
+
+  for (const auto& search : searches) {
+    batch.push_back(search.gains);
+  }
+  const auto initial_costs = evaluate();
+  for (std::size_t i = 0; i < searches.size(); ++i) {
+    searches[i].cost      = initial_costs[i];
+    searches[i].objective = detail::score(initial_costs[i], options);
+  }
+
+  for (std::size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    std::vector<Search*> active;
+    batch.clear();
+    for (auto& search : searches) {
+      if (min_step <= search.log_step) {
+        active.push_back(&search);
+        for (std::size_t o = 1; o < offsets.size(); ++o) {
+          batch.push_back(shifted(search.gains, offsets[o], search.log_step));
+        }
+      }
+    }
+    if (active.empty()) {
+      break;
+    }
+    const auto        costs     = evaluate();
+    const std::size_t neighbors = offsets.size() - 1;
+    for (std::size_t a = 0; a < active.size(); ++a) {
+      Search&     search = *active[a];
+      std::size_t best   = neighbors;
+      T           value  = search.objective;
+      for (std::size_t n = 0; n < neighbors; ++n) {
+        const T candidate = detail::score(costs[a * neighbors + n], options);
+        if (candidate < value) {
+          best  = n;
+          value = candidate;
+        }
+      }
+      if (best == neighbors) {
+        search.log_step /= T(2);
+      } else {
+        search.gains     = batch[a * neighbors + best];
+        search.cost      = costs[a * neighbors + best];
+        search.objective = value;
+      }
+    }
+  }
+
+  const auto best = std::min_element(searches.begin(), searches.end(), [](const auto& a, const auto& b) {
+    return a.objective < b.objective;
+  });
+  return { best->gains, best->cost, best->objective, evaluations };
+}
+
+template<std::floating_point T>
+TuneResult<T>
+refine(
+  const Gains<std::type_identity_t<T>>& initial,
+  const TransferFunction<T>&            model,
+  const TuneOptions<T>&                 options
+)
+{
+  return refine(initial, model, options, [](std::size_t capacity) { return pid_bank<T>(capacity); });
+}
+
+} // namespace mamePID
+
+#endif // MAMEPID_TUNE_HPP_
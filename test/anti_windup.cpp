@@ -0,0 +1,106 @@
+#include <array>
+#include <cmath>
+#include <ranges>
+
+#include <mamePID.hpp>
+
+#include "utest.h"
+
+// PI controller whose accumulator may wind up to +-10 while the output is limited to +-1.
+template<template<typename> typename IntegralT>
+auto
+pi_with_wide_accumulator(double kp, double ki, double dt)
+{
+  using P = mamePID::Proportional<double>;
+  using I = IntegralT<double>;
+  return mamePID::PID<double, P, I, mamePID::Zero<double>>(P(kp, dt), I(ki, dt, -10.0, 10.0), {}, -1.0, 1.0);
+}
+
+// The setpoint steps from 3 to -1 with pv held at 0; kp = 1 and ki * dt = 0.5, so every value is exact
+// in binary floating point.
+template<template<typename> typename IntegralT>
+std::array<double, 11>
+recovery()
+{
+  auto                   controller = pi_with_wide_accumulator<IntegralT>(1.0, 1.0, 0.5);
+  std::array<double, 11> output;
+  for (auto i : std::views::iota(0, 11)) {
+    output[i] = controller.calculate(i < 3 ? 3.0 : -1.0, 0.0);
+  }
+  return output;
+}
+
+UTEST(anti_windup, clamped_integral_winds_up)
+{
+  const std::array<double, 11> expected{ 1, 1, 1, 1, 1, 1, 1, 1, 0.5, 0, -0.5 };
+  const auto                   output = recovery<mamePID::Integral>();
+  for (auto i : std::views::iota(0, 11)) {
+    ASSERT_EQ(output[i], expected[i]);
+  }
+}
+
+UTEST(anti_windup, back_calculation)
+{
+  const std::array<double, 11> expected{ 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1 };
+  const auto                   output = recovery<mamePID::BackCalculationIntegral>();
+  for (auto i : std::views::iota(0, 11)) {
+    ASSERT_EQ(output[i], expected[i]);
+  }
+}
+
+UTEST(anti_windup, conditional_integration)
+{
+  const std::array<double, 11> expected{ 1, 1, 1, 0, -0.5, -1, -1, -1, -1, -1, -1 };
+  const auto                   output = recovery<mamePID::ConditionalIntegral>();
+  for (auto i : std::views::iota(0, 11)) {
+    ASSERT_EQ(output[i], expected[i]);
+  }
+}
+
+UTEST(anti_windup, freeze)
+{
+  const std::array<double, 11> expected{ 1, 1, 1, 0.5, 0, -0.5, -1, -1, -1, -1, -1 };
+  const auto                   output = recovery<mamePID::FreezingIntegral>();
+  for (auto i : std::views::iota(0, 11)) {
+    ASSERT_EQ(output[i], expected[i]);
+  }
+}
+
+// First-order plant driven into saturation by an unreachable setpoint, then asked for a reachable one.
+// Returns the number of steps after the change until the plant stays within 2% of the new setpoint.
+template<template<typename> typename IntegralT>
+int
+settling_steps()
+{
+  auto   controller = pi_with_wide_accumulator<IntegralT>(0.5, 2.0, 0.01);
+  double y          = 0.0;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 2000)) {
+    y += 0.01 * (controller.calculate(2.0, y) - y);
+  }
+  int settled = 0;
+  for (auto i : std::views::iota(0, 4000)) {
+    y += 0.01 * (controller.calculate(0.5, y) - y);
+    if (0.01 < std::abs(y - 0.5)) {
+      settled = i + 1;
+    }
+  }
+  return settled;
+}
+
+UTEST(anti_windup, recovers_faster_than_clamping)
+{
+  const int clamped = settling_steps<mamePID::Integral>();
+  ASSERT_LT(settling_steps<mamePID::BackCalculationIntegral>(), clamped);
+  ASSERT_LT(settling_steps<mamePID::ConditionalIntegral>(), clamped);
+  ASSERT_LT(settling_steps<mamePID::FreezingIntegral>(), clamped);
+}
+
+UTEST(anti_windup, feedback_reaches_calculate_terms)
+{
+  auto a = mamePID::i_pd<mamePID::BackCalculationIntegral>(0.8, 2.3, 0.05, 0.1, -1.0, 1.0);
+  auto b = a;
+  for (auto i : std::views::iota(0, 32)) {
+    const double setpoint = i < 16 ? 4.0 : -4.0;
+    ASSERT_EQ(a.calculate(setpoint, 0.0), b.calculate_terms(setpoint, 0.0).output);
+  }
+}
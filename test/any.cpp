@@ -0,0 +1,67 @@
+#include <cmath>
+#include <ranges>
+#include <vector>
+
+#include <mamePID/any.hpp>
+
+#include "utest.h"
+
+static_assert(std::is_nothrow_move_constructible_v<mamePID::AnyController<double>>);
+
+UTEST(any, mixed_population)
+{
+  std::vector<mamePID::AnyController<double>> controllers;
+  controllers.emplace_back(mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+  controllers.emplace_back(mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+  controllers.emplace_back(mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+  controllers.emplace_back(mamePID::velocity_pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+  controllers.emplace_back(mamePID::pid<0.8, 2.3, 0.05, 0.01, -1.0, 1.0>());
+
+  auto pid      = mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto pi_d     = mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto i_pd     = mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto velocity = mamePID::velocity_pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto fixed    = mamePID::pid<0.8, 2.3, 0.05, 0.01, -1.0, 1.0>();
+  for (auto i : std::views::iota(0, 64)) {
+    const double pv = std::sin(0.2 * i);
+    ASSERT_EQ(controllers[0].calculate(1.0, pv), pid.calculate(1.0, pv));
+    ASSERT_EQ(controllers[1].calculate(1.0, pv), pi_d.calculate(1.0, pv));
+    ASSERT_EQ(controllers[2].calculate(1.0, pv), i_pd.calculate(1.0, pv));
+    ASSERT_EQ(controllers[3].calculate(1.0, pv), velocity.calculate(1.0, pv));
+    ASSERT_EQ(controllers[4].calculate(1.0, pv), fixed.calculate(1.0, pv));
+  }
+}
+
+UTEST(any, copies_own_their_state)
+{
+  mamePID::AnyController<double> a = mamePID::pid(0.8, 2.3, 0.05, 0.01);
+  a.calculate(1.0, 0.0);
+  mamePID::AnyController<double> b = a;
+  ASSERT_EQ(a.calculate(1.0, 0.5), b.calculate(1.0, 0.5));
+  a.calculate(1.0, 0.2);
+  ASSERT_NE(a.calculate(1.0, 0.5), b.calculate(1.0, 0.5));
+
+  mamePID::AnyController<double> c = std::move(a);
+  ASSERT_TRUE(static_cast<bool>(c));
+  ASSERT_FALSE(static_cast<bool>(a));
+  a = c;
+  ASSERT_EQ(a.calculate(1.0, 0.1), c.calculate(1.0, 0.1));
+}
+
+UTEST(any, target)
+{
+  using Pid = decltype(mamePID::pid(0.8, 2.3, 0.05, 0.01));
+  using PiD = decltype(mamePID::pi_d(0.8, 2.3, 0.05, 0.01));
+
+  mamePID::AnyController<double> any = mamePID::pid(0.8, 2.3, 0.05, 0.01);
+  ASSERT_TRUE(any.target<Pid>() != nullptr);
+  ASSERT_TRUE(any.target<PiD>() == nullptr);
+
+  any.target<Pid>()->setKp(0.0);
+  any.target<Pid>()->setKi(0.0);
+  any.target<Pid>()->setKd(0.0);
+  ASSERT_EQ(any.calculate(1.0, 0.0), 0.0);
+
+  any.reset();
+  ASSERT_TRUE(any.target<Pid>() == nullptr);
+}
@@ -0,0 +1,190 @@
+#include <coroutine>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <mamePID/async.hpp>
+
+#include "utest.h"
+
+namespace {
+
+// Stand-in for an asynchronous IO layer. Writes to an actuator complete on the next poll() of the event
+// loop, which then steps a first-order plant and completes the pending sensor read with its new output.
+struct FakeIo
+{
+  struct Actuator
+  {
+    FakeIo*     io;
+    std::size_t loop;
+
+    auto write(double u)
+    {
+      struct Awaiter
+      {
+        FakeIo*     io;
+        std::size_t loop;
+        double      u;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { io->requests.push_back({ loop, u, handle }); }
+        void await_resume() const noexcept {}
+      };
+      return Awaiter{ io, loop, u };
+    }
+  };
+
+  struct Request
+  {
+    std::size_t             loop;
+    double                  u;
+    std::coroutine_handle<> writer;
+  };
+
+  explicit FakeIo(mamePID::Executor& executor, std::size_t n)
+    : executor(executor)
+    , y(n, 0.0)
+  {
+    for (std::size_t i = 0; i < n; ++i) {
+      sensors.push_back(std::make_unique<mamePID::Mailbox<double>>(executor));
+      sensors.back()->push(0.0);
+      actuators.push_back({ this, i });
+    }
+  }
+
+  static double plant(double y, double u) { return y + 0.1 * (2.0 * u - y); }
+
+  // Completes every pending write; returns false when there was none.
+  bool poll()
+  {
+    auto done = std::move(requests);
+    requests.clear();
+    for (const auto& request : done) {
+      y[request.loop] = plant(y[request.loop], request.u);
+      sensors[request.loop]->push(y[request.loop]);
+      executor.post(request.writer);
+    }
+    return !done.empty();
+  }
+
+  mamePID::Executor&                                     executor;
+  std::vector<double>                                    y;
+  std::vector<std::unique_ptr<mamePID::Mailbox<double>>> sensors;
+  std::vector<Actuator>                                  actuators;
+  std::vector<Request>                                   requests;
+};
+
+mamePID::Task
+fail(mamePID::Mailbox<double>& sensor)
+{
+  co_await sensor.read();
+  throw std::runtime_error("sensor fault");
+}
+
+} // namespace
+
+UTEST(async, loops_match_synchronous_run)
+{
+  constexpr std::size_t n = 1000, steps = 200;
+  mamePID::Executor     executor;
+  FakeIo                io(executor, n);
+
+  std::vector<decltype(mamePID::pid(1.0, 1.0, 1.0, 0.1))> controllers;
+  std::vector<double>                                     setpoints(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    controllers.push_back(mamePID::pid(0.5 + 0.001 * i, 1.0, 0.01, 0.1, -5.0, 5.0));
+    setpoints[i] = 1.0 + 0.01 * i;
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    executor.spawn(mamePID::drive(controllers[i], *io.sensors[i], io.actuators[i], setpoints[i], steps));
+  }
+  ASSERT_EQ(executor.active(), n);
+
+  // The event loop: run everything that is ready, then complete the IO it started.
+  do {
+    executor.run();
+  } while (io.poll());
+  ASSERT_EQ(executor.active(), 0u);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    auto                pid = mamePID::pid(0.5 + 0.001 * i, 1.0, 0.01, 0.1, -5.0, 5.0);
+    std::vector<double> sp(steps, setpoints[i]), out(steps);
+    double              y = 0.0;
+    pid.run(sp, 0.0, [&](double u) { return y = FakeIo::plant(y, u); }, out);
+    ASSERT_EQ(io.y[i], y);
+  }
+}
+
+UTEST(async, mailbox_keeps_the_latest_value)
+{
+  mamePID::Executor        executor;
+  mamePID::Mailbox<double> mailbox(executor);
+  ASSERT_FALSE(mailbox.try_read().has_value());
+  mailbox.push(1.0);
+  mailbox.push(2.0);
+  ASSERT_EQ(*mailbox.try_read(), 2.0);
+
+  // A reader without a value waits for the next push and is resumed through the executor. The output
+  // goes back into the same mailbox.
+  auto   pid = mamePID::pi(1.0, 0.0, 0.1);
+  double sp  = 3.0;
+  executor.spawn(mamePID::drive(pid, mailbox, mailbox, sp, 1));
+  ASSERT_EQ(executor.run(), 1u);
+  ASSERT_EQ(executor.active(), 1u);
+  mailbox.push(1.0);
+  ASSERT_EQ(executor.pending(), 1u);
+  ASSERT_TRUE(executor.run_one());
+  ASSERT_EQ(executor.active(), 0u);
+  ASSERT_EQ(*mailbox.try_read(), 2.0);
+}
+
+UTEST(async, posted_reader_keeps_its_value)
+{
+  mamePID::Executor        executor;
+  mamePID::Mailbox<double> sensor(executor), actuator(executor);
+  auto                     pid = mamePID::pi(1.0, 0.0, 0.1);
+  double                   sp  = 3.0;
+  executor.spawn(mamePID::drive(pid, sensor, actuator, sp, 1));
+  executor.run();
+
+  // Between the push that posts the reader and its resumption, the value is reserved for the reader.
+  sensor.push(1.0);
+  ASSERT_FALSE(sensor.try_read().has_value());
+  ASSERT_TRUE(executor.run_one());
+  ASSERT_EQ(executor.active(), 0u);
+  ASSERT_EQ(*actuator.try_read(), 2.0);
+}
+
+UTEST(async, mailbox_outlives_executor)
+{
+  auto                     executor = std::make_unique<mamePID::Executor>();
+  mamePID::Mailbox<double> sensor(*executor), actuator(*executor);
+  auto                     pid = mamePID::pi(1.0, 0.0, 0.1);
+  double                   sp  = 3.0;
+  executor->spawn(mamePID::drive(pid, sensor, actuator, sp, 1));
+  executor->run();
+
+  // The executor frees the waiting reader, and the mailbox forgets it: without its executor the mailbox
+  // is a plain slot.
+  executor.reset();
+  sensor.push(1.0);
+  ASSERT_EQ(*sensor.try_read(), 1.0);
+  ASSERT_FALSE(actuator.try_read().has_value());
+}
+
+UTEST(async, exceptions_reach_run)
+{
+  mamePID::Executor        executor;
+  mamePID::Mailbox<double> sensor(executor);
+  executor.spawn(fail(sensor));
+  executor.run();
+  sensor.push(0.0);
+  bool thrown = false;
+  try {
+    executor.run();
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  ASSERT_TRUE(thrown);
+  ASSERT_EQ(executor.active(), 0u);
+}
@@ -0,0 +1,149 @@
+#include <array>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <mamePID/bank.hpp>
+
+#include "utest.h"
+
+// Derivative filter coefficient given to the loop with sampling period sp in filtered banks.
+template<typename T>
+T
+filter_n(T sp)
+{
+  return T(0.1) / sp;
+}
+
+template<typename T, typename Bank, typename Factory>
+void
+run_bank_test(int* utest_result, Bank bank, Factory factory)
+{
+  constexpr int n     = 37;
+  constexpr int steps = 64;
+
+  std::mt19937                      rng(42);
+  std::uniform_real_distribution<T> gain(0.0, 2.0);
+  std::uniform_real_distribution<T> signal(-1.0, 1.0);
+
+  std::vector<decltype(factory(mamePID::Gains<T>{}, T{}, T{}, T{}))> scalars;
+  for (auto i : std::views::iota(0, n)) {
+    const mamePID::Gains<T> gains{ gain(rng), gain(rng), gain(rng) };
+    const T                 sp  = 0.01 * (i + 1);
+    const T                 min = -1.0 - i % 3;
+    const T                 max = 1.0 + i % 5;
+    const auto              index = bank.push_back(gains, sp, min, max);
+    if constexpr (Bank::filtered) {
+      bank.set_filter(index, filter_n(sp));
+    }
+    scalars.push_back(factory(gains, sp, min, max));
+  }
+  ASSERT_EQ(bank.size(), static_cast<std::size_t>(n));
+
+  std::vector<T> setpoints(n), pvs(n), out(n);
+  for (auto step : std::views::iota(0, steps)) {
+    for (auto i : std::views::iota(0, n)) {
+      setpoints[i] = signal(rng);
+      pvs[i]       = signal(rng);
+    }
+    bank.calculate(setpoints, pvs, out);
+    for (auto i : std::views::iota(0, n)) {
+      ASSERT_EQ_MSG(out[i], scalars[i].calculate(setpoints[i], pvs[i]), std::to_string(step).c_str());
+    }
+  }
+}
+
+UTEST(bank, pid)
+{
+  run_bank_test<double>(utest_result, mamePID::pid_bank<double>(), [](auto g, auto sp, auto min, auto max) {
+    return mamePID::pid(g.kp, g.ki, g.kd, sp, min, max);
+  });
+}
+
+UTEST(bank, pi)
+{
+  run_bank_test<double>(utest_result, mamePID::pi_bank<double>(), [](auto g, auto sp, auto min, auto max) {
+    return mamePID::pi(g.kp, g.ki, sp, min, max);
+  });
+}
+
+UTEST(bank, pd)
+{
+  run_bank_test<double>(utest_result, mamePID::pd_bank<double>(), [](auto g, auto sp, auto min, auto max) {
+    return mamePID::pd(g.kp, g.kd, sp, min, max);
+  });
+}
+
+UTEST(bank, pi_d)
+{
+  run_bank_test<double>(utest_result, mamePID::pi_d_bank<double>(), [](auto g, auto sp, auto min, auto max) {
+    return mamePID::pi_d(g.kp, g.ki, g.kd, sp, min, max);
+  });
+}
+
+UTEST(bank, i_pd)
+{
+  run_bank_test<double>(utest_result, mamePID::i_pd_bank<double>(), [](auto g, auto sp, auto min, auto max) {
+    return mamePID::i_pd(g.kp, g.ki, g.kd, sp, min, max);
+  });
+}
+
+UTEST(bank, pid_float)
+{
+  run_bank_test<float>(utest_result, mamePID::pid_bank<float>(), [](auto g, auto sp, auto min, auto max) {
+    return mamePID::pid(g.kp, g.ki, g.kd, sp, min, max);
+  });
+}
+
+UTEST(bank, pid_filtered)
+{
+  run_bank_test<double>(
+    utest_result, mamePID::pid_filtered_bank<double>(), [](auto g, auto sp, auto min, auto max) {
+      return mamePID::pid_filtered(g.kp, g.ki, g.kd, filter_n(sp), sp, min, max);
+    }
+  );
+}
+
+UTEST(bank, pi_d_filtered)
+{
+  run_bank_test<double>(
+    utest_result, mamePID::pi_d_filtered_bank<double>(), [](auto g, auto sp, auto min, auto max) {
+      return mamePID::pi_d_filtered(g.kp, g.ki, g.kd, filter_n(sp), sp, min, max);
+    }
+  );
+}
+
+UTEST(bank, i_pd_filtered)
+{
+  run_bank_test<float>(
+    utest_result, mamePID::i_pd_filtered_bank<float>(), [](auto g, auto sp, auto min, auto max) {
+      return mamePID::i_pd_filtered(g.kp, g.ki, g.kd, filter_n(sp), sp, min, max);
+    }
+  );
+}
+
+// Filtered banks start unfiltered, and set_gains recomputes the filter like PID::setGains.
+UTEST(bank, filter_follows_gains)
+{
+  auto bank       = mamePID::pid_filtered_bank<double>();
+  auto unfiltered = mamePID::pid(1.0, 0.5, 0.2, 0.01);
+  bank.push_back({ 1.0, 0.5, 0.2 }, 0.01);
+
+  std::array<double, 1> setpoint{ 1.0 }, pv{}, out{};
+  for (auto i : std::views::iota(0, 8)) {
+    pv[0] = 0.1 * i;
+    bank.calculate(setpoint, pv, out);
+    ASSERT_EQ(out[0], unfiltered.calculate(setpoint[0], pv[0]));
+  }
+
+  auto reference = mamePID::pid_filtered(2.0, 0.5, 0.1, 5.0, 0.01);
+  bank           = mamePID::pid_filtered_bank<double>();
+  bank.push_back({ 1.0, 0.5, 0.1 }, 0.01);
+  bank.set_filter(0, 5.0);
+  bank.set_gains(0, { 2.0, 0.5, 0.1 });
+  for (auto i : std::views::iota(0, 8)) {
+    pv[0] = 0.1 * i;
+    bank.calculate(setpoint, pv, out);
+    ASSERT_EQ(out[0], reference.calculate(setpoint[0], pv[0]));
+  }
+}
@@ -0,0 +1,110 @@
+#include <array>
+#include <cmath>
+#include <ranges>
+#include <vector>
+
+#include <mamePID/cascade.hpp>
+
+#include "utest.h"
+
+UTEST(cascade, matches_chained_calls)
+{
+  auto cascade = mamePID::cascade(
+    mamePID::pid(2.0, 0.5, 0.0, 0.004, -5.0, 5.0), mamePID::pi(0.8, 4.0, 0.001, -1.0, 1.0), 4
+  );
+  auto outer = mamePID::pid(2.0, 0.5, 0.0, 0.004, -5.0, 5.0);
+  auto inner = mamePID::pi(0.8, 4.0, 0.001, -1.0, 1.0);
+
+  double inner_sp = 0;
+  for (auto i : std::views::iota(0, 64)) {
+    const double position = std::sin(0.05 * i);
+    const double velocity = std::cos(0.05 * i);
+    if (i % 4 == 0) {
+      inner_sp = outer.calculate(1.0, position);
+    }
+    ASSERT_EQ(cascade.calculate(1.0, position, velocity), inner.calculate(inner_sp, velocity));
+    ASSERT_EQ(cascade.inner_setpoint(), inner_sp);
+  }
+  ASSERT_EQ(cascade.min(), -1.0);
+  ASSERT_EQ(cascade.max(), 1.0);
+  static_assert(!mamePID::Component<decltype(cascade), double>);
+}
+
+UTEST(cascade, run_matches_calculate)
+{
+  auto make = [] {
+    return mamePID::cascade(
+      mamePID::pid(2.0, 0.5, 0.0, 0.003, -5.0, 5.0), mamePID::pid(0.8, 4.0, 0.01, 0.001, -1.0, 1.0), 3
+    );
+  };
+  auto stepped = make();
+  auto batched = make();
+
+  std::vector<double> setpoints(50, 1.0), positions(50), velocities(50), out(50);
+  for (auto i : std::views::iota(0, 50)) {
+    positions[i]  = std::sin(0.1 * i);
+    velocities[i] = std::cos(0.1 * i);
+  }
+  // Split so that the second span starts in the middle of an outer period.
+  const std::span<const double> sp(setpoints), x(positions), v(velocities);
+  batched.run(sp.first(7), x.first(7), v.first(7), std::span(out).first(7));
+  batched.run(sp.subspan(7), x.subspan(7), v.subspan(7), std::span(out).subspan(7));
+  for (auto i : std::views::iota(0, 50)) {
+    ASSERT_EQ(out[i], stepped.calculate(setpoints[i], positions[i], velocities[i]));
+  }
+  ASSERT_EQ(batched.calculate(1.0, 0.5, 0.5), stepped.calculate(1.0, 0.5, 0.5));
+}
+
+// Position loop around a velocity loop on a double integrator; the position must settle on the setpoint.
+UTEST(cascade, settles_position_loop)
+{
+  const double dt      = 0.001;
+  auto         outer   = mamePID::pid(4.0, 0.0, 0.0, 5 * dt, -2.0, 2.0);
+  auto         inner   = mamePID::pi(20.0, 50.0, dt, -10.0, 10.0);
+  auto         cascade = mamePID::cascade(outer, inner, 5);
+  double       position = 0, velocity = 0;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 5000)) {
+    const double acceleration = cascade.calculate(1.0, position, velocity);
+    velocity += acceleration * dt;
+    position += velocity * dt;
+  }
+  ASSERT_NEAR(position, 1.0, 1e-3);
+  ASSERT_NEAR(velocity, 0.0, 1e-2);
+}
+
+UTEST(cascade, bank_matches_scalar)
+{
+  const std::array<mamePID::Gains<double>, 3> outer_gains{ { { 2.0, 0.5, 0.0 },
+                                                             { 1.5, 0.0, 0.1 },
+                                                             { 3.0, 1.0, 0.0 } } };
+  const std::array<mamePID::Gains<double>, 3> inner_gains{ { { 0.8, 4.0, 0.0 },
+                                                             { 0.6, 2.0, 0.0 },
+                                                             { 1.0, 3.0, 0.0 } } };
+
+  using Scalar = decltype(mamePID::cascade(mamePID::pid(0.0, 0.0, 0.0, 0.002), mamePID::pi(0.0, 0.0, 0.001)));
+
+  auto bank = mamePID::cascade_bank(mamePID::pid_bank<double>(), mamePID::pi_bank<double>(), 2);
+
+  std::vector<Scalar> scalar;
+  for (std::size_t i = 0; i < 3; ++i) {
+    bank.outer().push_back(outer_gains[i], 0.002, -5.0, 5.0);
+    bank.inner().push_back(inner_gains[i], 0.001, -1.0, 1.0);
+    scalar.push_back(mamePID::cascade(
+      mamePID::pid(outer_gains[i].kp, outer_gains[i].ki, outer_gains[i].kd, 0.002, -5.0, 5.0),
+      mamePID::pi(inner_gains[i].kp, inner_gains[i].ki, 0.001, -1.0, 1.0),
+      2
+    ));
+  }
+
+  std::array<double, 3> setpoints{ 1.0, -0.5, 0.25 }, positions{}, velocities{}, out{};
+  for (auto k : std::views::iota(0, 40)) {
+    for (std::size_t i = 0; i < 3; ++i) {
+      positions[i]  = std::sin(0.1 * k + i);
+      velocities[i] = std::cos(0.1 * k + i);
+    }
+    bank.calculate(setpoints, positions, velocities, out);
+    for (std::size_t i = 0; i < 3; ++i) {
+      ASSERT_EQ(out[i], scalar[i].calculate(setpoints[i], positions[i], velocities[i]));
+    }
+  }
+}
@@ -0,0 +1,625 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <mamePID/bank.hpp>
+#include <mamePID/fixed.hpp>
+#include <refsim/refsim.hpp>
+
+#include "utest.h"
+
+// Sweeps random gains, sampling periods, limits, setpoint weights, filter coefficients and input sequences
+// through the factories in float and double, and through every bank kernel the machine supports, against
+// the long double control law of tools/refsim, which shares no code with mamePID. Q15 banks are swept with
+// gains and inputs that fit the format. MAMEPID_DIFF_CASES overrides the number of random cases per sweep.
+
+namespace {
+
+using mamePID::Q15;
+using refsim::Real;
+
+constexpr int steps = 16;
+
+struct Parameters
+{
+  double   kp, ki, kd, dt, min, max;
+  double   b, c, n;
+  double   scale;
+  unsigned seed;
+};
+
+// Parameters rounded to the type under test. The reference is built from the same rounded values, so
+// only the arithmetic is compared.
+template<typename T>
+struct Rounded
+{
+  T kp, ki, kd, dt, min, max;
+  T b, c, n;
+};
+
+// Terms of the variant under test.
+struct Form
+{
+  refsim::Architecture arch       = refsim::Architecture::PID;
+  bool                 integral   = true;
+  bool                 derivative = true;
+  bool                 weighted   = false;
+  bool                 filtered   = false;
+  bool                 velocity   = false;
+};
+
+constexpr Form pi_form{ .derivative = false };
+constexpr Form pd_form{ .integral = false };
+constexpr Form pid_form{};
+constexpr Form pi_d_form{ .arch = refsim::Architecture::PI_D };
+constexpr Form i_pd_form{ .arch = refsim::Architecture::I_PD };
+constexpr Form pid_2dof_form{ .weighted = true };
+
+constexpr Form
+filtered(Form form)
+{
+  form.filtered = true;
+  return form;
+}
+
+constexpr Form
+velocity(Form form)
+{
+  form.velocity = true;
+  return form;
+}
+
+std::size_t
+case_count()
+{
+  std::size_t cases = 1 << 18;
+  if (const char* env = std::getenv("MAMEPID_DIFF_CASES")) {
+    cases = std::strtoull(env, nullptr, 10);
+  }
+  return cases;
+}
+
+Parameters
+random_parameters(std::mt19937_64& rng)
+{
+  const auto log_uniform = [&](double lo, double hi) {
+    return std::exp(std::uniform_real_distribution<double>(std::log(lo), std::log(hi))(rng));
+  };
+  Parameters p;
+  p.kp    = log_uniform(1e-3, 1e2);
+  p.ki    = log_uniform(1e-3, 1e2);
+  p.kd    = log_uniform(1e-4, 1e1);
+  p.dt    = log_uniform(1e-4, 1e-1);
+  p.scale = log_uniform(1e-3, 1e3);
+  p.min   = std::numeric_limits<double>::lowest();
+  p.max   = std::numeric_limits<double>::max();
+  switch (std::uniform_int_distribution<int>(0, 2)(rng)) {
+    case 0:
+      break;
+    case 1:
+      p.max = log_uniform(1e-2, 1e4);
+      p.min = -p.max;
+      break;
+    default:
+      p.min = -log_uniform(1e-2, 1e4);
+      p.max = log_uniform(1e-2, 1e4);
+      break;
+  }
+  p.b    = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+  p.c    = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+  p.n    = log_uniform(1.0, 1e3);
+  p.seed = static_cast<unsigned>(rng());
+  return p;
+}
+
+// Q15 holds [-1, 1), so ki stays below one, kd / dt below a quarter and the limits inside the range.
+Parameters
+random_fixed_parameters(std::mt19937_64& rng)
+{
+  const auto uniform = [&](double lo, double hi) {
+    return std::uniform_real_distribution<double>(lo, hi)(rng);
+  };
+  Parameters p;
+  p.dt    = uniform(1.0 / 16, 0.5);
+  p.kp    = uniform(0.0, 0.5);
+  p.ki    = uniform(0.0, 0.9);
+  p.kd    = uniform(0.0, 0.25) * p.dt;
+  p.max   = uniform(0.1, 0.9);
+  p.min   = -uniform(0.1, 0.9);
+  p.b     = uniform(0.0, 1.0);
+  p.c     = uniform(0.0, 1.0);
+  p.n     = 1.0;
+  p.scale = 0.25;
+  p.seed  = static_cast<unsigned>(rng());
+  return p;
+}
+
+template<typename T>
+std::vector<Parameters>
+random_cases(std::size_t cases)
+{
+  std::mt19937_64         rng(0x6d616d65);
+  std::vector<Parameters> parameters(cases);
+  std::generate(parameters.begin(), parameters.end(), [&] {
+    return std::floating_point<T> ? random_parameters(rng) : random_fixed_parameters(rng);
+  });
+  return parameters;
+}
+
+template<typename T>
+Rounded<T>
+round_to(const Parameters& p)
+{
+  // Unbounded limits must stay unbounded in the narrower type.
+  const T min = p.min == std::numeric_limits<double>::lowest() ? std::numeric_limits<T>::lowest() : T(p.min);
+  const T max = p.max == std::numeric_limits<double>::max() ? std::numeric_limits<T>::max() : T(p.max);
+  return { T(p.kp), T(p.ki), T(p.kd), T(p.dt), min, max, T(p.b), T(p.c), T(p.n) };
+}
+
+template<typename T>
+refsim::Law
+reference_law(const Rounded<T>& p, const Form& form)
+{
+  refsim::Law law;
+  law.kp       = Real(p.kp);
+  law.ki       = form.integral ? Real(p.ki) : 0;
+  law.kd       = form.derivative ? Real(p.kd) : 0;
+  law.sp       = Real(p.dt);
+  law.b        = form.weighted ? Real(p.b) : (form.arch == refsim::Architecture::I_PD ? 0 : 1);
+  law.c        = form.weighted ? Real(p.c) : (form.arch == refsim::Architecture::PID ? 1 : 0);
+  law.n        = form.filtered ? Real(p.n) : std::numeric_limits<Real>::infinity();
+  law.minv     = Real(p.min);
+  law.maxv     = Real(p.max);
+  law.velocity = form.velocity;
+  return law;
+}
+
+// Condition of an update: every input enters through setpoint and pv, so with m_k = |setpoint_k| + |pv_k|
+// the terms are bounded by kp m_k, ki dt (m_0 + ... + m_k) and the filtered kd / (tf + dt) (m_k + m_{k-1}).
+// The velocity form sums the bounds of its increments. Floating-point errors are relative to it.
+class Condition
+{
+public:
+  explicit Condition(const refsim::Law& law)
+    : law(law)
+    , tf(law.kp == 0 || std::isinf(law.n) ? 0 : law.kd / (law.kp * law.n))
+  {
+  }
+
+  Real step(Real m)
+  {
+    sum += m;
+    if (law.velocity) {
+      total += law.kp * (m + m1) + law.ki * law.sp * m + law.kd / law.sp * (m + 2 * m1 + m2);
+    } else {
+      derivative = tf / (tf + law.sp) * derivative + law.kd / (tf + law.sp) * (m + m1);
+      total      = law.kp * m + law.ki * law.sp * sum + derivative;
+    }
+    m2 = m1;
+    m1 = m;
+    return total;
+  }
+
+private:
+  refsim::Law law;
+  Real        tf;
+  Real        sum        = 0;
+  Real        total      = 0;
+  Real        derivative = 0;
+  Real        m1         = 0;
+  Real        m2         = 0;
+};
+
+// Error of one output: relative to the condition for floating point, in units of the last place for
+// fixed point, whose rounding does not scale with the values.
+template<typename T>
+double
+error(T y, Real expected, Real condition)
+{
+  if constexpr (std::floating_point<T>) {
+    return static_cast<double>(std::abs(Real(y) - expected) / condition);
+  } else {
+    return static_cast<double>(std::abs(Real(y) - expected) * Real(1 << T::frac_bits));
+  }
+}
+
+// Allowed worst case: 8 units of roundoff relative to the condition, or for Q15, which rounds the gains
+// and each term once, 4 units of the last place.
+template<typename T>
+double
+bound()
+{
+  if constexpr (std::floating_point<T>) {
+    return 8.0 * std::numeric_limits<T>::epsilon();
+  } else {
+    return 4.0;
+  }
+}
+
+template<typename T>
+void
+random_inputs(const Parameters& p, T* setpoints, T* pvs, std::size_t stride)
+{
+  std::minstd_rand                       rng(p.seed);
+  std::uniform_real_distribution<double> signal(-p.scale, p.scale);
+  for (int k = 0; k < steps; ++k) {
+    setpoints[k * stride] = T(signal(rng));
+    pvs[k * stride]       = T(signal(rng));
+  }
+}
+
+struct Report
+{
+  double worst;
+  double p50;
+  double p99;
+  double p999;
+  bool   in_limits;
+};
+
+template<typename T>
+const char*
+type_name()
+{
+  if constexpr (std::is_same_v<T, float>) {
+    return "float";
+  } else if constexpr (std::is_same_v<T, double>) {
+    return "double";
+  } else {
+    return "Q15";
+  }
+}
+
+template<typename T>
+Report
+summarize(const char* name, const char* path, std::vector<double>& errors, const std::vector<char>& in_limits)
+{
+  const std::size_t cases = errors.size();
+  std::sort(errors.begin(), errors.end());
+  const auto at = [&](double q) { return errors[std::min(cases - 1, static_cast<std::size_t>(q * cases))]; };
+  const bool   all_in_limits = std::ranges::all_of(in_limits, [](char ok) { return ok != 0; });
+  const Report report{ errors.back(), at(0.5), at(0.99), at(0.999), all_in_limits };
+  std::printf(
+    "differential %-14s %-6s %-6s cases %zu steps %d | p50 %.2e p99 %.2e p99.9 %.2e worst %.2e\n",
+    name,
+    type_name<T>(),
+    path,
+    cases,
+    steps,
+    report.p50,
+    report.p99,
+    report.p999,
+    report.worst
+  );
+  return report;
+}
+
+// Largest error over one input sequence of a controller built by factory.
+template<typename T, typename Factory>
+double
+case_error(Factory factory, const Form& form, const Parameters& p, bool& in_limits)
+{
+  const auto         rounded    = round_to<T>(p);
+  auto               controller = factory(rounded);
+  const auto         law        = reference_law(rounded, form);
+  refsim::Controller reference(law);
+  Condition          condition(law);
+
+  std::array<T, steps> setpoints, pvs;
+  random_inputs(p, setpoints.data(), pvs.data(), 1);
+  double worst = 0;
+  for (int k = 0; k < steps; ++k) {
+    const T    y        = controller.calculate(setpoints[k], pvs[k]);
+    const Real expected = reference.step(Real(setpoints[k]), Real(pvs[k]));
+    const Real scale    = condition.step(std::abs(Real(setpoints[k])) + std::abs(Real(pvs[k])));
+    in_limits           = in_limits && rounded.min <= y && y <= rounded.max;
+    worst               = std::max(worst, error(y, expected, scale));
+  }
+  return worst;
+}
+
+template<typename T, typename Factory>
+Report
+sweep(const char* name, const Form& form, Factory factory)
+{
+  const auto parameters = random_cases<T>(case_count());
+  const auto cases      = parameters.size();
+
+  std::vector<double> errors(cases);
+  std::vector<char>   in_limits(cases);
+  refsim::parallel_for(cases, std::thread::hardware_concurrency(), [&](std::size_t i) {
+    bool ok      = true;
+    errors[i]    = case_error<T>(factory, form, parameters[i], ok);
+    in_limits[i] = ok;
+  });
+  return summarize<T>(name, "scalar", errors, in_limits);
+}
+
+template<typename Factory>
+void
+run_differential_test(int* utest_result, const char* name, const Form& form, Factory factory)
+{
+  const auto f = sweep<float>(name, form, factory);
+  ASSERT_TRUE(f.in_limits);
+  ASSERT_LT(f.worst, bound<float>());
+
+  const auto d = sweep<double>(name, form, factory);
+  ASSERT_TRUE(d.in_limits);
+  ASSERT_LT(d.worst, bound<double>());
+}
+
+constexpr std::array isas = { mamePID::simd::Isa::Scalar,
+                              mamePID::simd::Isa::SSE2,
+                              mamePID::simd::Isa::AVX2,
+                              mamePID::simd::Isa::AVX512 };
+
+constexpr const char*
+isa_name(mamePID::simd::Isa isa)
+{
+  switch (isa) {
+    case mamePID::simd::Isa::Scalar:
+      return "scalar";
+    case mamePID::simd::Isa::SSE2:
+      return "SSE2";
+    case mamePID::simd::Isa::AVX2:
+      return "AVX2";
+    case mamePID::simd::Isa::AVX512:
+      return "AVX512";
+  }
+  return "";
+}
+
+// 16-bit Fixed banks have no SSE2 kernel; that request runs the scalar path already swept.
+template<typename T>
+bool
+has_kernel(mamePID::simd::Isa isa)
+{
+  return mamePID::simd::supported(isa) && (std::floating_point<T> || isa != mamePID::simd::Isa::SSE2);
+}
+
+template<typename Bank, typename T>
+void
+add_loop(Bank& bank, const Rounded<T>& p)
+{
+  const mamePID::Gains<T> gains{ p.kp, p.ki, p.kd };
+  if constexpr (Bank::weighted) {
+    bank.push_back(gains, { p.b, p.c }, p.dt, p.min, p.max);
+  } else {
+    const std::size_t index = bank.push_back(gains, p.dt, p.min, p.max);
+    if constexpr (Bank::filtered) {
+      bank.set_filter(index, p.n);
+    }
+  }
+}
+
+// Steps the cases as the lanes of banks, one bank per chunk of cases and instruction set, and reports
+// every instruction set against the same reference. As every case runs through up to four kernels, bank
+// sweeps take a quarter of the cases.
+template<typename T, typename MakeBank>
+void
+run_bank_test(int* utest_result, const char* name, const Form& form, MakeBank make_bank)
+{
+  constexpr std::size_t chunk      = 1024;
+  const auto            parameters = random_cases<T>(std::max<std::size_t>(1, case_count() / 4));
+  const auto            cases      = parameters.size();
+
+  std::vector<std::vector<double>> errors(isas.size(), std::vector<double>(cases));
+  std::vector<std::vector<char>>   in_limits(isas.size(), std::vector<char>(cases, 1));
+  const std::size_t                chunks = (cases + chunk - 1) / chunk;
+  refsim::parallel_for(chunks, std::thread::hardware_concurrency(), [&](std::size_t j) {
+    const std::size_t begin = j * chunk;
+    const std::size_t n     = std::min(chunk, cases - begin);
+
+    std::vector<Rounded<T>> rounded(n);
+    std::vector<T>          setpoints(steps * n), pvs(steps * n);
+    std::vector<Real>       expected(steps * n), scale(steps * n);
+    for (std::size_t i = 0; i < n; ++i) {
+      rounded[i] = round_to<T>(parameters[begin + i]);
+      random_inputs(parameters[begin + i], setpoints.data() + i, pvs.data() + i, n);
+      const auto         law = reference_law(rounded[i], form);
+      refsim::Controller reference(law);
+      Condition          condition(law);
+      for (std::size_t k = 0; k < steps; ++k) {
+        const Real r        = Real(setpoints[k * n + i]);
+        const Real y        = Real(pvs[k * n + i]);
+        expected[k * n + i] = reference.step(r, y);
+        scale[k * n + i]    = condition.step(std::abs(r) + std::abs(y));
+      }
+    }
+
+    std::vector<T> out(n);
+    for (std::size_t s = 0; s < isas.size(); ++s) {
+      if (!has_kernel<T>(isas[s])) {
+        continue;
+      }
+      auto bank = make_bank(T{});
+      for (const auto& p : rounded) {
+        add_loop(bank, p);
+      }
+      for (std::size_t k = 0; k < steps; ++k) {
+        bank.calculate(
+          std::span(setpoints).subspan(k * n, n), std::span(pvs).subspan(k * n, n), std::span(out), isas[s]
+        );
+        for (std::size_t i = 0; i < n; ++i) {
+          auto& worst = errors[s][begin + i];
+          auto& ok    = in_limits[s][begin + i];
+          worst       = std::max(worst, error(out[i], expected[k * n + i], scale[k * n + i]));
+          ok          = ok && rounded[i].min <= out[i] && out[i] <= rounded[i].max;
+        }
+      }
+    }
+  });
+
+  for (std::size_t s = 0; s < isas.size(); ++s) {
+    if (!has_kernel<T>(isas[s])) {
+      continue;
+    }
+    const auto report = summarize<T>(name, isa_name(isas[s]), errors[s], in_limits[s]);
+    ASSERT_TRUE(report.in_limits);
+    ASSERT_LT(report.worst, bound<T>());
+  }
+}
+
+} // namespace
+
+UTEST(differential, pi)
+{
+  run_differential_test(utest_result, "pi", pi_form, [](const auto& p) {
+    return mamePID::pi(p.kp, p.ki, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, pd)
+{
+  run_differential_test(utest_result, "pd", pd_form, [](const auto& p) {
+    return mamePID::pd(p.kp, p.kd, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, pid)
+{
+  run_differential_test(utest_result, "pid", pid_form, [](const auto& p) {
+    return mamePID::pid(p.kp, p.ki, p.kd, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, pi_d)
+{
+  run_differential_test(utest_result, "pi_d", pi_d_form, [](const auto& p) {
+    return mamePID::pi_d(p.kp, p.ki, p.kd, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, i_pd)
+{
+  run_differential_test(utest_result, "i_pd", i_pd_form, [](const auto& p) {
+    return mamePID::i_pd(p.kp, p.ki, p.kd, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, pid_2dof)
+{
+  run_differential_test(utest_result, "pid_2dof", pid_2dof_form, [](const auto& p) {
+    return mamePID::pid_2dof(p.kp, p.ki, p.kd, p.b, p.c, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, pid_filtered)
+{
+  run_differential_test(utest_result, "pid_filtered", filtered(pid_form), [](const auto& p) {
+    return mamePID::pid_filtered(p.kp, p.ki, p.kd, p.n, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, pi_d_filtered)
+{
+  run_differential_test(utest_result, "pi_d_filtered", filtered(pi_d_form), [](const auto& p) {
+    return mamePID::pi_d_filtered(p.kp, p.ki, p.kd, p.n, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, i_pd_filtered)
+{
+  run_differential_test(utest_result, "i_pd_filtered", filtered(i_pd_form), [](const auto& p) {
+    return mamePID::i_pd_filtered(p.kp, p.ki, p.kd, p.n, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, velocity_pid)
+{
+  run_differential_test(utest_result, "velocity_pid", velocity(pid_form), [](const auto& p) {
+    return mamePID::velocity_pid(p.kp, p.ki, p.kd, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, velocity_pi_d)
+{
+  run_differential_test(utest_result, "velocity_pi_d", velocity(pi_d_form), [](const auto& p) {
+    return mamePID::velocity_pi_d(p.kp, p.ki, p.kd, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, velocity_i_pd)
+{
+  run_differential_test(utest_result, "velocity_i_pd", velocity(i_pd_form), [](const auto& p) {
+    return mamePID::velocity_i_pd(p.kp, p.ki, p.kd, p.dt, p.min, p.max);
+  });
+}
+
+UTEST(differential, pi_bank)
+{
+  const auto make = [](auto zero) { return mamePID::pi_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "pi_bank", pi_form, make);
+  run_bank_test<double>(utest_result, "pi_bank", pi_form, make);
+  run_bank_test<Q15>(utest_result, "pi_bank", pi_form, make);
+}
+
+UTEST(differential, pd_bank)
+{
+  const auto make = [](auto zero) { return mamePID::pd_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "pd_bank", pd_form, make);
+  run_bank_test<double>(utest_result, "pd_bank", pd_form, make);
+  run_bank_test<Q15>(utest_result, "pd_bank", pd_form, make);
+}
+
+UTEST(differential, pid_bank)
+{
+  const auto make = [](auto zero) { return mamePID::pid_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "pid_bank", pid_form, make);
+  run_bank_test<double>(utest_result, "pid_bank", pid_form, make);
+  run_bank_test<Q15>(utest_result, "pid_bank", pid_form, make);
+}
+
+UTEST(differential, pi_d_bank)
+{
+  const auto make = [](auto zero) { return mamePID::pi_d_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "pi_d_bank", pi_d_form, make);
+  run_bank_test<double>(utest_result, "pi_d_bank", pi_d_form, make);
+  run_bank_test<Q15>(utest_result, "pi_d_bank", pi_d_form, make);
+}
+
+UTEST(differential, i_pd_bank)
+{
+  const auto make = [](auto zero) { return mamePID::i_pd_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "i_pd_bank", i_pd_form, make);
+  run_bank_test<double>(utest_result, "i_pd_bank", i_pd_form, make);
+  run_bank_test<Q15>(utest_result, "i_pd_bank", i_pd_form, make);
+}
+
+UTEST(differential, pid_2dof_bank)
+{
+  const auto make = [](auto zero) { return mamePID::pid_2dof_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "pid_2dof_bank", pid_2dof_form, make);
+  run_bank_test<double>(utest_result, "pid_2dof_bank", pid_2dof_form, make);
+  run_bank_test<Q15>(utest_result, "pid_2dof_bank", pid_2dof_form, make);
+}
+
+UTEST(differential, pid_filtered_bank)
+{
+  const auto make = [](auto zero) { return mamePID::pid_filtered_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "pid_filtered_bank", filtered(pid_form), make);
+  run_bank_test<double>(utest_result, "pid_filtered_bank", filtered(pid_form), make);
+}
+
+UTEST(differential, pi_d_filtered_bank)
+{
+  const auto make = [](auto zero) { return mamePID::pi_d_filtered_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "pi_d_filtered_bank", filtered(pi_d_form), make);
+  run_bank_test<double>(utest_result, "pi_d_filtered_bank", filtered(pi_d_form), make);
+}
+
+UTEST(differential, i_pd_filtered_bank)
+{
+  const auto make = [](auto zero) { return mamePID::i_pd_filtered_bank<decltype(zero)>(); };
+  run_bank_test<float>(utest_result, "i_pd_filtered_bank", filtered(i_pd_form), make);
+  run_bank_test<double>(utest_result, "i_pd_filtered_bank", filtered(i_pd_form), make);
+}
@@ -0,0 +1,122 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <ranges>
+
+#include <mamePID.hpp>
+
+#include "utest.h"
+
+// kp = kd = n = dt = 1 gives tf = 1, so the response to a unit error step halves on every sample.
+UTEST(filtered_derivative, step_response)
+{
+  mamePID::FilteredDerivative<double> derivative(1.0, 1.0, 1.0, 1.0);
+  double                              expected = 1.0;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 16)) {
+    expected /= 2;
+    ASSERT_EQ(derivative.calculate(1.0, 0.0), expected);
+  }
+}
+
+UTEST(filtered_derivative, preceding_ignores_setpoint)
+{
+  mamePID::PrecedingFilteredDerivative<double> derivative(1.0, 1.0, 1.0, 1.0);
+  ASSERT_EQ(derivative.calculate(5.0, 1.0), -0.5);
+  ASSERT_EQ(derivative.calculate(-5.0, 1.0), -0.25);
+}
+
+UTEST(filtered_derivative, infinite_n_is_unfiltered)
+{
+  constexpr double inf    = std::numeric_limits<double>::infinity();
+  auto             pid    = mamePID::pid(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  auto             pi_d   = mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  auto             i_pd   = mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  auto             pid_f  = mamePID::pid_filtered(0.8, 2.3, 0.05, inf, 0.01, -10.0, 10.0);
+  auto             pi_d_f = mamePID::pi_d_filtered(0.8, 2.3, 0.05, inf, 0.01, -10.0, 10.0);
+  auto             i_pd_f = mamePID::i_pd_filtered(0.8, 2.3, 0.05, inf, 0.01, -10.0, 10.0);
+
+  std::minstd_rand                       rng(7);
+  std::uniform_real_distribution<double> pv(-1.0, 1.0);
+  for ([[maybe_unused]] auto i : std::views::iota(0, 1000)) {
+    const double y = pv(rng);
+    ASSERT_EQ(pid_f.calculate(1.0, y), pid.calculate(1.0, y));
+    ASSERT_EQ(pi_d_f.calculate(1.0, y), pi_d.calculate(1.0, y));
+    ASSERT_EQ(i_pd_f.calculate(1.0, y), i_pd.calculate(1.0, y));
+  }
+}
+
+UTEST(filtered_derivative, matches_continuous_filter)
+{
+  // Backward Euler of kd * s / (1 + s * tf) evaluated in long double.
+  const long double kp = 2.0L, kd = 0.3L, n = 8.0L, dt = 0.001L;
+  const long double tf = kd / (kp * n);
+
+  mamePID::FilteredDerivative<double> derivative(0.3, 0.001, 2.0, 8.0);
+  std::minstd_rand                    rng(11);
+  std::normal_distribution<double>    noise(0.0, 0.1);
+  long double                         filtered = 0, pre_error = 0;
+  for (auto i : std::views::iota(0, 5000)) {
+    const double error = std::sin(0.01 * i) + noise(rng);
+    filtered           = (tf * filtered + kd * (error - pre_error)) / (tf + dt);
+    pre_error          = error;
+    ASSERT_NEAR(derivative.calculate(error, 0.0), static_cast<double>(filtered), 1e-9);
+  }
+}
+
+UTEST(filtered_derivative, attenuates_sensor_noise)
+{
+  mamePID::Derivative<double>         raw(0.05, 0.001);
+  mamePID::FilteredDerivative<double> filtered(0.05, 0.001, 1.0, 10.0);
+
+  std::minstd_rand                 rng(3);
+  std::normal_distribution<double> noise(0.0, 0.01);
+  double                           raw_power = 0, filtered_power = 0;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 20000)) {
+    const double pv = noise(rng);
+    raw_power      += std::pow(raw.calculate(0.0, pv), 2);
+    filtered_power += std::pow(filtered.calculate(0.0, pv), 2);
+  }
+  // tf = 5 ms against dt = 1 ms: white noise power drops by more than an order of magnitude.
+  ASSERT_LT(filtered_power * 10, raw_power);
+}
+
+UTEST(filtered_derivative, set_gain_recomputes_filter)
+{
+  auto a = mamePID::pid_filtered(1.0, 0.5, 0.1, 10.0, 0.01);
+  auto b = mamePID::pid_filtered(1.0, 0.5, 0.2, 10.0, 0.01);
+  a.setKd(0.2);
+  for (auto i : std::views::iota(0, 100)) {
+    const double pv = std::cos(0.1 * i);
+    ASSERT_EQ(a.calculate(1.0, pv), b.calculate(1.0, pv));
+  }
+}
+
+UTEST(filtered_derivative, set_kp_recomputes_filter)
+{
+  auto a = mamePID::pid_filtered(1.0, 0.5, 0.1, 10.0, 0.01);
+  auto b = mamePID::pid_filtered(2.0, 0.5, 0.1, 10.0, 0.01);
+  auto c = mamePID::i_pd_filtered(1.0, 0.5, 0.1, 10.0, 0.01);
+  auto d = mamePID::i_pd_filtered(2.0, 0.7, 0.3, 10.0, 0.01);
+  a.setKp(2.0);
+  c.setGains({ 2.0, 0.7, 0.3 });
+  for (auto i : std::views::iota(0, 100)) {
+    const double pv = std::cos(0.1 * i);
+    ASSERT_EQ(a.calculate(1.0, pv), b.calculate(1.0, pv));
+    ASSERT_EQ(c.calculate(1.0, pv), d.calculate(1.0, pv));
+  }
+}
+
+UTEST(filtered_derivative, zero_kp_is_unfiltered)
+{
+  auto pid    = mamePID::pid(0.0, 1.0, 0.1, 0.01);
+  auto i_pd   = mamePID::i_pd(0.0, 1.0, 0.1, 0.01);
+  auto pid_f  = mamePID::pid_filtered(0.0, 1.0, 0.1, 10.0, 0.01);
+  auto i_pd_f = mamePID::i_pd_filtered(0.0, 1.0, 0.1, 10.0, 0.01);
+  for (auto i : std::views::iota(0, 100)) {
+    const double pv = std::cos(0.1 * i);
+    ASSERT_EQ(pid_f.calculate(1.0, pv), pid.calculate(1.0, pv));
+    ASSERT_EQ(i_pd_f.calculate(1.0, pv), i_pd.calculate(1.0, pv));
+  }
+  // Also with a varying period.
+  ASSERT_TRUE(std::isfinite(pid_f.calculate(1.0, 0.0, 0.02)));
+}
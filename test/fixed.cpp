@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cstdint>
+#include <ranges>
+
+#include <mamePID/bank.hpp>
+#include <mamePID/fixed.hpp>
+
+#include "testcases/general_i_pd.hpp"
+#include "testcases/general_pi_d.hpp"
+#include "testcases/general_pid.hpp"
+#include "utest.h"
+
+using mamePID::Q15;
+using mamePID::Q31;
+using Q16 = mamePID::Fixed<std::int32_t, 16>;
+using Q32 = mamePID::Fixed<std::int64_t, 32>;
+
+static_assert(Q15(0.5) * Q15(0.5) == Q15(0.25));
+static_assert(Q15(0.75) + Q15(0.75) == std::numeric_limits<Q15>::max());
+static_assert(Q15(-0.75) - Q15(0.75) == std::numeric_limits<Q15>::lowest());
+static_assert(-Q15(-1.0) == std::numeric_limits<Q15>::max());
+static_assert(Q15(0.25) / Q15(0.5) == Q15(0.5));
+static_assert(Q15(0.25) / Q15(0) == std::numeric_limits<Q15>::max());
+static_assert(Q15(1) == std::numeric_limits<Q15>::max());
+static_assert(Q15(-1).raw() == -32768);
+static_assert(Q16(3) * Q16(-2.5) == Q16(-7.5));
+static_assert(Q15(Q31(0.5)) == Q15(0.5));
+static_assert(mamePID::mac(Q15(0.5), Q15(0.5), Q15(0.5)) == Q15(0.75));
+static_assert(mamePID::mac(Q15(0.5), Q15(0.75), Q15(0.75)) == std::numeric_limits<Q15>::max());
+
+UTEST(fixed, rounding)
+{
+  ASSERT_EQ((Q15::from_raw(1) * Q15(0.5)).raw(), 1);
+  ASSERT_EQ((Q15::from_raw(-1) * Q15(0.5)).raw(), 0);
+  ASSERT_EQ((Q15::from_raw(1) / Q15::from_raw(2)).raw(), Q15(0.5).raw());
+  ASSERT_NEAR(static_cast<double>(Q31(0.1)), 0.1, 1e-9);
+}
+
+// ki * dt * error is a sixth of one Q15 LSB here, so an integrator that rounded to Q15 on every step
+// would never move.
+UTEST(fixed, integral_keeps_sub_lsb_increments)
+{
+  mamePID::Integral<Q15> integral(Q15(0.01), Q15(0.001));
+  Q15                    output;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 1000)) {
+    output = integral.calculate(Q15(0.5), Q15(0));
+  }
+  const double expected = static_cast<double>(Q15(0.01)) * static_cast<double>(Q15(0.001)) * 0.5 * 1000;
+  ASSERT_NEAR(static_cast<double>(output), expected, 1.0 / 32768);
+}
+
+// Ten times the nominal period: a dt / nominal ratio would saturate the [-2, 2) Q15 accumulator at 2.
+UTEST(fixed, integral_long_step)
+{
+  mamePID::Integral<Q15> integral(Q15(0.5), Q15(0.001));
+  Q15                    output;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 10)) {
+    output = integral.calculate(Q15(0.5), Q15(0), Q15(0.01));
+  }
+  const double expected = static_cast<double>(Q15(0.5)) * static_cast<double>(Q15(0.01)) * 0.5 * 10;
+  ASSERT_NEAR(static_cast<double>(output), expected, 1.0 / 32768);
+}
+
+template<typename T, typename TC, typename Factory>
+void
+run_fixed_step_response(int* utest_result, Factory factory)
+{
+  auto controller = factory(T(TC::kp), T(TC::ki), T(TC::kd), T(TC::sp));
+  T    pv{};
+  for (auto i : std::views::iota(0, static_cast<int>(TC::output.size()))) {
+    pv = controller.calculate(T(TC::g), pv);
+    // The general_* loops diverge to ~1e7, where Q32 rounding shows up relative to the magnitude.
+    ASSERT_NEAR(static_cast<double>(pv), TC::output[i], 1e-3 + 1e-8 * std::abs(TC::output[i]));
+  }
+}
+
+UTEST(fixed, general_pid)
+{
+  run_fixed_step_response<Q32, testcases::general_pid>(utest_result, [](auto... args) {
+    return mamePID::pid(args...);
+  });
+}
+
+UTEST(fixed, general_pi_d)
+{
+  run_fixed_step_response<Q32, testcases::general_pi_d>(utest_result, [](auto... args) {
+    return mamePID::pi_d(args...);
+  });
+}
+
+UTEST(fixed, general_i_pd)
+{
+  run_fixed_step_response<Q32, testcases::general_i_pd>(utest_result, [](auto... args) {
+    return mamePID::i_pd(args...);
+  });
+}
+
+UTEST(fixed, q31_saturates_at_limits)
+{
+  auto pid = mamePID::pid(Q31(0.5), Q31(0.5), Q31(0.001), Q31(0.01), Q31(-0.5), Q31(0.5));
+  for ([[maybe_unused]] auto i : std::views::iota(0, 100)) {
+    ASSERT_EQ(pid.calculate(Q31(0.9), Q31(-0.9)).raw(), Q31(0.5).raw());
+  }
+  Q31 output;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 300)) {
+    output = pid.calculate(Q31(-0.9), Q31(0.9));
+  }
+  ASSERT_EQ(output.raw(), Q31(-0.5).raw());
+}
+
+UTEST(fixed, bank_matches_scalar)
+{
+  auto bank   = mamePID::pid_bank<Q16>();
+  auto scalar = mamePID::pid(Q16(0.8), Q16(2.3), Q16(0.05), Q16(0.1), Q16(-2), Q16(2));
+  bank.push_back({ Q16(0.8), Q16(2.3), Q16(0.05) }, Q16(0.1), Q16(-2), Q16(2));
+
+  std::array<Q16, 1> setpoint{ Q16(1.2) }, pv{}, out{};
+  for ([[maybe_unused]] auto i : std::views::iota(0, 32)) {
+    bank.calculate(setpoint, pv, out);
+    ASSERT_EQ(out[0].raw(), scalar.calculate(setpoint[0], pv[0]).raw());
+    pv = out;
+  }
+}
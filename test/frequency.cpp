@@ -0,0 +1,128 @@
+#include <array>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <vector>
+
+#include <mamePID/frequency.hpp>
+
+#include "utest.h"
+
+namespace {
+
+// Responses from setpoint and from pv as the z-transforms of the impulse responses, truncated where
+// they have decayed below the tolerance. |z| > 1 keeps the integrator sum finite.
+template<typename C>
+mamePID::Response<double>
+impulse_response(const C& controller, std::complex<double> z)
+{
+  mamePID::Response<double> result{};
+  C                         from_setpoint = controller, from_pv = controller;
+  std::complex<double>      power{ 1.0 };
+  for (int k = 0; k < 400; ++k) {
+    const double impulse = k == 0 ? 1.0 : 0.0;
+    result.setpoint += from_setpoint.calculate(impulse, 0.0) * power;
+    result.feedback -= from_pv.calculate(0.0, impulse) * power;
+    power /= z;
+  }
+  return result;
+}
+
+template<typename C>
+bool
+matches(const C& controller)
+{
+  const auto z        = std::polar(1.3, 0.7);
+  const auto expected = impulse_response(controller, z);
+  const auto actual   = controller.response(z);
+  return std::abs(actual.setpoint - expected.setpoint) < 1e-9 &&
+         std::abs(actual.feedback - expected.feedback) < 1e-9;
+}
+
+// Largest error over the last window samples of a unit step response of controller against model.
+template<typename C>
+double
+tail_error(C controller, const mamePID::TransferFunction<double>& model, int steps, int window)
+{
+  mamePID::PlantBank    plant(model, 1);
+  std::array<double, 1> u{}, y{};
+  double                error = 0;
+  for (int k = 0; k < steps; ++k) {
+    u[0] = controller.calculate(1.0, y[0]);
+    plant.step(u, y);
+    error = steps - window <= k ? std::max(error, std::abs(1.0 - y[0])) : 0.0;
+  }
+  return error;
+}
+
+} // namespace
+
+UTEST(frequency, responses_match_impulse_responses)
+{
+  ASSERT_TRUE(matches(mamePID::pid(2.0, 3.0, 0.1, 0.01)));
+  ASSERT_TRUE(matches(mamePID::pi_d(2.0, 3.0, 0.1, 0.01)));
+  ASSERT_TRUE(matches(mamePID::i_pd(2.0, 3.0, 0.1, 0.01)));
+  ASSERT_TRUE(matches(mamePID::pid_2dof(2.0, 3.0, 0.1, 0.5, 0.2, 0.01)));
+  ASSERT_TRUE(matches(mamePID::pid_filtered(2.0, 3.0, 0.1, 10.0, 0.01)));
+  ASSERT_TRUE(matches(mamePID::i_pd_filtered(2.0, 3.0, 0.1, 10.0, 0.01)));
+  ASSERT_TRUE(matches(mamePID::pid<mamePID::BackCalculationIntegral>(2.0, 3.0, 0.1, 0.01)));
+  ASSERT_TRUE(matches(mamePID::velocity_pid(2.0, 3.0, 0.1, 0.01)));
+  ASSERT_TRUE(matches(mamePID::velocity_i_pd(2.0, 3.0, 0.1, 0.01)));
+}
+
+UTEST(frequency, margins_predict_closed_loop_stability)
+{
+  const double dt    = 0.001;
+  const auto   model = mamePID::first_order_dead_time(1.5, 0.5, 0.1, dt);
+  const auto   omega = mamePID::log_grid(0.01, 0.9 * std::numbers::pi / dt, 2000);
+  const auto   m     = mamePID::margins(mamePID::pid(1.0, 2.0, 0.02, dt), model, std::span(omega));
+  ASSERT_GT(m.gain, 1.5);
+  ASSERT_GT(m.phase, 20.0);
+
+  // Scaling all gains by the gain margin puts the loop on the stability limit.
+  const auto scaled = [&](double factor) {
+    return mamePID::pid(factor * 1.0, factor * 2.0, factor * 0.02, dt);
+  };
+  ASSERT_LT(tail_error(scaled(0.95 * m.gain), model, 20000, 2000), 0.05);
+  ASSERT_GT(tail_error(scaled(1.05 * m.gain), model, 20000, 2000), 1.0);
+
+  // So does adding the dead time that uses up the phase margin at the gain crossover.
+  const double extra = m.phase * std::numbers::pi / 180 / m.gain_crossover;
+  const auto   slower = [&](double factor) {
+    return mamePID::first_order_dead_time(1.5, 0.5, 0.1 + factor * extra, dt);
+  };
+  ASSERT_LT(tail_error(mamePID::pid(1.0, 2.0, 0.02, dt), slower(0.9), 40000, 2000), 0.05);
+  ASSERT_GT(tail_error(mamePID::pid(1.0, 2.0, 0.02, dt), slower(1.1), 40000, 2000), 1.0);
+}
+
+UTEST(frequency, bank_margins_match_controllers)
+{
+  const auto model = mamePID::second_order(2.0, 5.0, 0.4, 0.01);
+  const auto omega = mamePID::log_grid(0.01, 300.0, 500);
+
+  std::vector<mamePID::Gains<double>> loops;
+  for (int i = 0; i < 600; ++i) {
+    loops.push_back({ 0.2 + 0.01 * i, 0.5 + 0.005 * i, 0.0002 * (i % 11) });
+  }
+  const auto margins = mamePID::bank_margins(std::span(loops), model, std::span(omega));
+  ASSERT_EQ(margins.size(), loops.size());
+  for (std::size_t i = 0; i < loops.size(); ++i) {
+    const auto& g        = loops[i];
+    const auto  expected = mamePID::margins(mamePID::i_pd(g.kp, g.ki, g.kd, 0.01), model, std::span(omega));
+    ASSERT_NEAR(margins[i].gain, expected.gain, 1e-9 * expected.gain);
+    ASSERT_NEAR(margins[i].phase, expected.phase, 1e-9);
+    ASSERT_NEAR(margins[i].gain_crossover, expected.gain_crossover, 1e-9);
+  }
+  // Higher gains leave less margin.
+  ASSERT_LT(margins.back().gain, margins.front().gain);
+}
+
+UTEST(frequency, margins_without_crossings)
+{
+  // A low-gain P loop on a plant without dead time never reaches -180 degrees or unit gain.
+  const auto model = mamePID::first_order_dead_time(1.0, 1.0, 0.0, 0.01);
+  const auto omega = mamePID::log_grid(0.01, 300.0, 200);
+  const auto m     = mamePID::margins(mamePID::pd(0.5, 0.0, 0.01), model, std::span(omega));
+  ASSERT_TRUE(std::isinf(m.phase));
+  ASSERT_TRUE(std::isnan(m.gain_crossover));
+}
@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <mamePID/multirate.hpp>
+
+#include "utest.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Advances by one millisecond on every call, so each group takes exactly 1 ms.
+struct StepClock
+{
+  using duration   = std::chrono::nanoseconds;
+  using rep        = duration::rep;
+  using period     = duration::period;
+  using time_point = std::chrono::time_point<StepClock>;
+
+  static constexpr bool is_steady = true;
+
+  static inline std::int64_t calls = 0;
+
+  static time_point now() { return time_point(std::chrono::milliseconds(calls++)); }
+};
+
+} // namespace
+
+UTEST(multirate, groups_run_at_their_rates)
+{
+  // 10 kHz, 1 kHz and 100 Hz loops on a 10 kHz base tick.
+  mamePID::RateScheduler<decltype(mamePID::pid(1.0, 1.0, 0.0, 1.0))> scheduler(100us);
+  std::vector<decltype(mamePID::pid(1.0, 1.0, 0.0, 1.0))>            reference;
+  std::vector<std::chrono::nanoseconds>                              periods;
+  for (int i = 0; i < 30; ++i) {
+    const auto period = i % 3 == 0 ? 10ms : (i % 3 == 1 ? 100us : 1ms);
+    const auto dt     = std::chrono::duration<double>(period).count();
+    const auto pid    = mamePID::pid(0.5 + 0.1 * i, 2.0, 0.001 * i, dt);
+    ASSERT_EQ(scheduler.add(pid, period), static_cast<std::size_t>(i));
+    reference.push_back(pid);
+    periods.push_back(period);
+  }
+  ASSERT_EQ(scheduler.group_count(), 3u);
+  ASSERT_EQ(scheduler.hyperperiod(), 100u);
+  ASSERT_TRUE(scheduler.group(0).period == 100us);
+  ASSERT_EQ(scheduler.group(2).controllers, 10u);
+
+  std::vector<double> setpoints(30, 1.0), pvs(30), out(30), expected(30);
+  for (std::uint64_t t = 0; t < 250; ++t) {
+    for (std::size_t i = 0; i < 30; ++i) {
+      pvs[i] = 0.01 * double((t + i) % 17);
+    }
+    const auto& tick = scheduler.tick(setpoints, pvs, out);
+    ASSERT_EQ(tick.tick, t);
+    ASSERT_EQ(tick.due, scheduler.due_on(t));
+    for (std::size_t i = 0; i < 30; ++i) {
+      if (t % static_cast<std::uint64_t>(periods[i] / 100us) == 0) {
+        expected[i] = reference[i].calculate(setpoints[i], pvs[i]);
+      }
+      ASSERT_EQ(out[i], expected[i]);
+    }
+  }
+  ASSERT_EQ(scheduler.group(0).runs, 250u);
+  ASSERT_EQ(scheduler.group(1).runs, 25u);
+  ASSERT_EQ(scheduler.group(2).runs, 3u);
+}
+
+UTEST(multirate, offsets_and_hyperperiod)
+{
+  mamePID::RateScheduler<decltype(mamePID::pi(1.0, 1.0, 0.1))> scheduler(1ms);
+  scheduler.add(mamePID::pi(1.0, 1.0, 0.004), 4ms, 1ms);
+  scheduler.add(mamePID::pi(1.0, 1.0, 0.006), 6ms);
+  scheduler.add(mamePID::pi(1.0, 1.0, 0.004), 4ms, 3ms);
+  ASSERT_EQ(scheduler.hyperperiod(), 12u);
+  ASSERT_EQ(scheduler.group_count(), 3u);
+
+  // Groups are ordered by period, then offset: 4 ms + 1, 4 ms + 3, 6 ms.
+  const std::uint64_t expected[12] = { 4, 1, 0, 2, 0, 1, 4, 2, 0, 1, 0, 2 };
+  for (std::uint64_t t = 0; t < 24; ++t) {
+    ASSERT_EQ(scheduler.due_on(t), expected[t % 12]);
+  }
+
+  // Adding a group later keeps the schedule position.
+  std::vector<double> values(3), out(3);
+  scheduler.tick(values, values, out);
+  scheduler.add(mamePID::pi(1.0, 1.0, 0.005), 5ms);
+  ASSERT_EQ(scheduler.hyperperiod(), 60u);
+  values.resize(4);
+  out.resize(4);
+  ASSERT_EQ(scheduler.tick(values, values, out).tick, 1u);
+  ASSERT_EQ(scheduler.last_tick().due, 1u);
+}
+
+UTEST(multirate, hyperperiod_is_capped)
+{
+  // A third coprime period of about a hundred base ticks would need a schedule of over 10^6 ticks.
+  mamePID::RateScheduler<decltype(mamePID::pi(1.0, 1.0, 0.1))> scheduler(1us, 100000);
+  scheduler.add(mamePID::pi(1.0, 1.0, 1e-6), 101us);
+  scheduler.add(mamePID::pi(1.0, 1.0, 1e-6), 103us);
+  ASSERT_EQ(scheduler.hyperperiod(), 101u * 103u);
+  ASSERT_EXCEPTION(scheduler.add(mamePID::pi(1.0, 1.0, 1e-6), 107us), std::length_error);
+
+  // The rejected controller left the schedule untouched; periods dividing the hyperperiod still fit.
+  ASSERT_EQ(scheduler.size(), 2u);
+  ASSERT_EQ(scheduler.group_count(), 2u);
+  scheduler.add(mamePID::pi(1.0, 1.0, 1e-6), 101us, 5us);
+  ASSERT_EQ(scheduler.hyperperiod(), 101u * 103u);
+}
+
+UTEST(multirate, overruns_are_flagged)
+{
+  using Controller = decltype(mamePID::pi(1.0, 1.0, 0.1));
+  mamePID::RateScheduler<Controller, StepClock> scheduler(1ms);
+  scheduler.add(mamePID::pi(1.0, 1.0, 0.001), 1ms);
+  scheduler.add(mamePID::pi(1.0, 1.0, 0.002), 2ms);
+  scheduler.add(mamePID::pi(1.0, 1.0, 0.002), 2ms, 1ms);
+  scheduler.set_deadline(2ms, 1ms, 1500us);
+
+  std::vector<double> values(3), out(3);
+  // Tick 0 runs the 1 ms group and then the 2 ms group, which finish 1 and 2 ms after the start.
+  const auto& first = scheduler.tick(values, values, out);
+  ASSERT_EQ(first.due, 3u);
+  ASSERT_EQ(first.overruns, 0u);
+  ASSERT_TRUE(first.wall == 2ms);
+  ASSERT_TRUE(scheduler.group(1).finish == 2ms);
+
+  // Tick 1 finishes the offset group 2 ms after the start, past its 1.5 ms deadline.
+  const auto& second = scheduler.tick(values, values, out);
+  ASSERT_EQ(second.due, 5u);
+  ASSERT_EQ(second.overruns, 4u);
+  ASSERT_EQ(scheduler.group(2).overruns, 1u);
+  ASSERT_EQ(scheduler.group(0).overruns, 0u);
+  ASSERT_TRUE(scheduler.group(0).worst == 1ms);
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <mamePID.hpp>
+#include <refsim/refsim.hpp>
+
+#include "utest.h"
+
+namespace {
+
+// Largest error of the closed-loop response of mamePID against the reference, relative to the largest
+// reference magnitude seen so far (at least 1), so growing responses are compared by their leading digits.
+double
+relative_error(const refsim::Case& c)
+{
+  const auto reference = refsim::simulate(c);
+
+  std::vector<double> setpoints(c.n, c.g), y(c.n);
+  const auto          identity = [](double u) { return u; };
+  switch (c.arch) {
+    case refsim::Architecture::PID:
+      mamePID::pid(c.kp, c.ki, c.kd, c.sp).run(setpoints, 0.0, identity, y);
+      break;
+    case refsim::Architecture::PI_D:
+      mamePID::pi_d(c.kp, c.ki, c.kd, c.sp).run(setpoints, 0.0, identity, y);
+      break;
+    case refsim::Architecture::I_PD:
+      mamePID::i_pd(c.kp, c.ki, c.kd, c.sp).run(setpoints, 0.0, identity, y);
+      break;
+  }
+
+  double       worst = 0.0;
+  refsim::Real scale = 1.0;
+  for (std::size_t k = 0; k < c.n; ++k) {
+    scale = std::max(scale, std::abs(reference[k]));
+    if (1e100 < scale) {
+      break;
+    }
+    worst = std::max(worst, static_cast<double>(std::abs(y[k] - reference[k]) / scale));
+  }
+  return worst;
+}
+
+} // namespace
+
+UTEST(refsim, matches_mamePID_on_random_cases)
+{
+  constexpr std::size_t cases = 3000;
+  constexpr std::size_t n     = 2000;
+  const auto            all   = refsim::random_cases(cases, n, 20240615);
+
+  std::vector<double> errors(cases);
+  refsim::parallel_for(cases, std::thread::hardware_concurrency(), [&](std::size_t i) {
+    errors[i] = relative_error(all[i]);
+  });
+
+  for (auto arch : refsim::architectures) {
+    // Cases per decade of error, from below 1e-15 up to 1e-6 and above.
+    std::array<int, 11> histogram{};
+    double              worst = 0.0;
+    for (std::size_t i = 0; i < cases; ++i) {
+      if (all[i].arch != arch) {
+        continue;
+      }
+      const int bin = errors[i] <= 0.0 ? 0 : static_cast<int>(std::floor(std::log10(errors[i]))) + 16;
+      histogram[std::clamp(bin, 0, 10)] += 1;
+      worst = std::max(worst, errors[i]);
+    }
+    std::printf("refsim %-4s worst %.3e |", refsim::to_string(arch), worst);
+    for (auto count : histogram) {
+      std::printf(" %d", count);
+    }
+    std::printf("\n");
+    ASSERT_LT(worst, 1e-9);
+  }
+}
@@ -0,0 +1,129 @@
+#include <cmath>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+#include <mamePID/registry.hpp>
+
+#include "utest.h"
+
+using PidT  = decltype(mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+using PiDT  = decltype(mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+using IPdT  = decltype(mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+using Mixed = mamePID::Registry<PidT, PiDT, IPdT>;
+
+UTEST(registry, handles_survive_compaction)
+{
+  mamePID::ControllerPool<PidT>      pool;
+  std::vector<mamePID::Handle<PidT>> handles;
+  for (auto i : std::views::iota(0, 8)) {
+    handles.push_back(pool.insert(mamePID::pid(0.1 * (i + 1), 2.3, 0.05, 0.01, -1.0, 1.0)));
+  }
+  ASSERT_TRUE(pool.erase(handles[0]));
+  ASSERT_TRUE(pool.erase(handles[3]));
+  ASSERT_EQ(pool.size(), 6u);
+
+  for (auto i : { 1, 2, 4, 5, 6, 7 }) {
+    auto* controller = pool.get(handles[i]);
+    ASSERT_TRUE(controller != nullptr);
+    auto reference = mamePID::pid(0.1 * (i + 1), 2.3, 0.05, 0.01, -1.0, 1.0);
+    ASSERT_EQ(controller->calculate(1.0, 0.25), reference.calculate(1.0, 0.25));
+  }
+}
+
+UTEST(registry, stale_handles_are_rejected)
+{
+  mamePID::ControllerPool<PidT> pool;
+  const auto                    first = pool.insert(mamePID::pid(0.8, 2.3, 0.05, 0.01));
+  ASSERT_TRUE(pool.erase(first));
+  ASSERT_FALSE(pool.erase(first));
+  ASSERT_TRUE(pool.get(first) == nullptr);
+  ASSERT_TRUE(pool.get(mamePID::Handle<PidT>{}) == nullptr);
+
+  // The slot is reused, but the old handle must not alias the new controller.
+  const auto second = pool.insert(mamePID::pid(0.8, 2.3, 0.05, 0.01));
+  ASSERT_EQ(second.index, first.index);
+  ASSERT_NE(second.generation, first.generation);
+  ASSERT_TRUE(pool.get(first) == nullptr);
+  ASSERT_TRUE(pool.get(second) != nullptr);
+}
+
+UTEST(registry, storage_stays_dense_and_aligned)
+{
+  mamePID::ControllerPool<PidT>      pool;
+  std::vector<mamePID::Handle<PidT>> handles;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 100)) {
+    handles.push_back(pool.insert(mamePID::pid(0.8, 2.3, 0.05, 0.01)));
+  }
+  for (auto i = 0; i < 100; i += 3) {
+    pool.erase(handles[i]);
+  }
+  ASSERT_EQ(pool.size(), 66u);
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(pool.controllers().data()) % mamePID::detail::cache_line, 0u);
+
+  // Every position maps back to a live handle, which maps back to the same position.
+  for (std::size_t i = 0; i < pool.size(); ++i) {
+    ASSERT_EQ(pool.get(pool.handle_at(i)), &pool.controllers()[i]);
+  }
+}
+
+UTEST(registry, mixed_compositions)
+{
+  Mixed registry;
+  auto  pid  = registry.insert(mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+  auto  pi_d = registry.insert(mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+  auto  i_pd = registry.insert(mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+  registry.insert(mamePID::pid(0.5, 1.0, 0.0, 0.01, -1.0, 1.0));
+  ASSERT_EQ(registry.size(), 4u);
+  ASSERT_EQ(registry.pool<PidT>().size(), 2u);
+
+  auto pid_ref  = mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto pi_d_ref = mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto i_pd_ref = mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  for (auto i : std::views::iota(0, 32)) {
+    const double pv = std::sin(0.2 * i);
+    ASSERT_EQ(registry.get(pid)->calculate(1.0, pv), pid_ref.calculate(1.0, pv));
+    ASSERT_EQ(registry.get(pi_d)->calculate(1.0, pv), pi_d_ref.calculate(1.0, pv));
+    ASSERT_EQ(registry.get(i_pd)->calculate(1.0, pv), i_pd_ref.calculate(1.0, pv));
+  }
+
+  ASSERT_TRUE(registry.erase(pi_d));
+  ASSERT_FALSE(registry.contains(pi_d));
+  ASSERT_EQ(registry.size(), 3u);
+}
+
+UTEST(registry, for_each_visits_every_controller_once)
+{
+  Mixed registry;
+  for (auto i : std::views::iota(0, 30)) {
+    switch (i % 3) {
+      case 0:
+        registry.insert(mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+        break;
+      case 1:
+        registry.insert(mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+        break;
+      default:
+        registry.insert(mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0));
+        break;
+    }
+  }
+  registry.erase(registry.pool<PiDT>().handle_at(0));
+
+  // A controller stepped twice from rest would differ from one stepped once.
+  registry.for_each([](auto& controller) { controller.calculate(1.0, 0.0); });
+  auto reference = mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  reference.calculate(1.0, 0.0);
+  const double expected = reference.calculate(1.0, 0.0);
+
+  int visited = 0;
+  registry.for_each_pool([&](auto& pool) {
+    if constexpr (std::same_as<typename std::remove_cvref_t<decltype(pool)>::controller_type, PidT>) {
+      for (auto& controller : pool) {
+        ASSERT_EQ(controller.calculate(1.0, 0.0), expected);
+      }
+    }
+    visited += static_cast<int>(pool.size());
+  });
+  ASSERT_EQ(visited, 29);
+}
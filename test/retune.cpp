@@ -0,0 +1,113 @@
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <thread>
+
+#include <mamePID/bank.hpp>
+#include <mamePID/retune.hpp>
+
+#include "utest.h"
+
+UTEST(retune, set_gains_matches_construction)
+{
+  auto retuned = mamePID::pid(1.0, 1.0, 1.0, 0.1);
+  auto fresh   = mamePID::pid(0.8, 2.3, 0.05, 0.1);
+  retuned.setGains({ 0.8, 2.3, 0.05 });
+
+  double pv = 0.0;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 32)) {
+    const double expected = fresh.calculate(1.2, pv);
+    ASSERT_EQ(retuned.calculate(1.2, pv), expected);
+    pv = expected;
+  }
+}
+
+UTEST(retune, mailbox_returns_latest_once)
+{
+  mamePID::GainMailbox<double> mailbox;
+  ASSERT_TRUE(mailbox.fetch() == nullptr);
+
+  mailbox.publish({ 1.0, 2.0, 3.0 });
+  mailbox.publish({ 4.0, 5.0, 6.0 });
+  const auto* gains = mailbox.fetch();
+  ASSERT_TRUE(gains != nullptr);
+  ASSERT_EQ(gains->kp, 4.0);
+  ASSERT_EQ(gains->kd, 6.0);
+  ASSERT_TRUE(mailbox.fetch() == nullptr);
+}
+
+UTEST(retune, mailbox_never_tears)
+{
+  constexpr int                n = 200000;
+  mamePID::GainMailbox<double> mailbox;
+
+  std::thread tuner([&] {
+    for (auto k : std::views::iota(1, n + 1)) {
+      mailbox.publish({ double(k), 2.0 * k, 3.0 * k });
+    }
+  });
+
+  double last = 0.0;
+  while (last < n) {
+    if (const auto* gains = mailbox.fetch()) {
+      ASSERT_EQ(gains->ki, 2.0 * gains->kp);
+      ASSERT_EQ(gains->kd, 3.0 * gains->kp);
+      ASSERT_LT(last, gains->kp);
+      last = gains->kp;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  tuner.join();
+}
+
+UTEST(retune, spsc_ring_keeps_order)
+{
+  constexpr std::size_t n    = 100000;
+  auto                  ring = std::make_unique<mamePID::SpscRing<std::size_t, 64>>();
+
+  std::thread producer([&] {
+    for (std::size_t i = 0; i < n;) {
+      if (ring->try_push(i)) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (std::size_t expected = 0; expected < n;) {
+    if (const auto value = ring->try_pop()) {
+      ASSERT_EQ(*value, expected);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  ASSERT_FALSE(ring->try_pop().has_value());
+}
+
+UTEST(retune, bank_applies_updates_before_next_step)
+{
+  auto bank = mamePID::pid_bank<double>();
+  bank.push_back({ 0.8, 2.3, 0.05 }, 0.1);
+  bank.push_back({ 1.0, 1.0, 1.0 }, 0.1);
+  auto retunable = std::make_unique<mamePID::RetunableBank<decltype(bank)>>(bank);
+
+  auto first  = mamePID::pid(0.8, 2.3, 0.05, 0.1);
+  auto second = mamePID::pid(1.0, 1.0, 1.0, 0.1);
+
+  std::array<double, 2> setpoint{ 1.2, -0.4 }, pv{}, out{};
+  for (auto i : std::views::iota(0, 32)) {
+    if (i == 10) {
+      ASSERT_TRUE(retunable->publish(1, { 0.5, 0.2, 0.01 }));
+      second.setGains({ 0.5, 0.2, 0.01 });
+    }
+    retunable->calculate(setpoint, pv, out);
+    ASSERT_EQ(out[0], first.calculate(setpoint[0], pv[0]));
+    ASSERT_EQ(out[1], second.calculate(setpoint[1], pv[1]));
+    pv = out;
+  }
+}
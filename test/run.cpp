@@ -0,0 +1,94 @@
+#include <array>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <mamePID.hpp>
+
+#include "testcases/general_i_pd.hpp"
+#include "testcases/general_pi_d.hpp"
+#include "testcases/general_pid.hpp"
+#include "utest.h"
+
+template<typename Controller>
+void
+run_open_loop_test(int* utest_result, Controller controller)
+{
+  std::mt19937                           rng(3);
+  std::uniform_real_distribution<double> signal(-1.0, 1.0);
+  std::vector<double>                    setpoints(1000), pvs(1000), out(1000);
+  for (auto i : std::views::iota(0, 1000)) {
+    setpoints[i] = signal(rng);
+    pvs[i]       = signal(rng);
+  }
+
+  auto reference = controller;
+  controller.run(std::span(setpoints).first(400), std::span(pvs).first(400), std::span(out).first(400));
+  controller.run(std::span(setpoints).subspan(400), std::span(pvs).subspan(400), std::span(out).subspan(400));
+  for (auto i : std::views::iota(0, 1000)) {
+    ASSERT_EQ(out[i], reference.calculate(setpoints[i], pvs[i]));
+  }
+}
+
+UTEST(run, pid_matches_calculate)
+{
+  run_open_loop_test(utest_result, mamePID::pid(0.8, 2.3, 0.05, 0.1, -2.0, 2.0));
+}
+
+UTEST(run, pi_d_matches_calculate)
+{
+  run_open_loop_test(utest_result, mamePID::pi_d(0.8, 2.3, 0.05, 0.1));
+}
+
+UTEST(run, static_i_pd_matches_calculate)
+{
+  run_open_loop_test(utest_result, mamePID::i_pd<0.8, 2.3, 0.05, 0.1>());
+}
+
+template<typename TC, typename Controller>
+void
+run_closed_loop_test(int* utest_result, Controller controller)
+{
+  std::array<double, TC::output.size()> setpoints, out;
+  setpoints.fill(TC::g);
+  const double last = controller.run(setpoints, 0.0, [](double u) { return u; }, out);
+  for (auto i : std::views::iota(std::size_t{ 0 }, out.size())) {
+    ASSERT_NEAR(out[i], TC::output[i], 1e-3);
+  }
+  ASSERT_EQ(last, out.back());
+}
+
+UTEST(run, closed_loop_general_pid)
+{
+  using TC = testcases::general_pid;
+  run_closed_loop_test<TC>(utest_result, mamePID::pid(TC::kp, TC::ki, TC::kd, TC::sp));
+}
+
+UTEST(run, closed_loop_general_pi_d)
+{
+  using TC = testcases::general_pi_d;
+  run_closed_loop_test<TC>(utest_result, mamePID::pi_d(TC::kp, TC::ki, TC::kd, TC::sp));
+}
+
+UTEST(run, closed_loop_general_i_pd)
+{
+  using TC = testcases::general_i_pd;
+  run_closed_loop_test<TC>(utest_result, mamePID::i_pd(TC::kp, TC::ki, TC::kd, TC::sp));
+}
+
+UTEST(run, closed_loop_first_order_plant)
+{
+  auto                controller = mamePID::pi(2.0, 1.0, 0.01);
+  auto                reference  = controller;
+  double              y          = 0.0;
+  const auto          plant      = [&y](double u) { return y += 0.01 * (u - y); };
+  std::vector<double> setpoints(500, 1.0), out(500);
+  controller.run(setpoints, 0.0, plant, out);
+
+  double pv = 0.0;
+  y         = 0.0;
+  for (auto i : std::views::iota(0, 500)) {
+    pv = plant(reference.calculate(1.0, pv));
+    ASSERT_EQ(out[i], pv);
+  }
+}
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <mamePID/scheduler.hpp>
+
+#include "utest.h"
+
+namespace {
+
+// P controller that sleeps on every step when slow, to make one shard take much longer than the others.
+struct Sleepy
+{
+  using value_type = double;
+
+  bool slow = false;
+
+  double calculate(double sp, double pv) const
+  {
+    if (slow) {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    return sp - pv;
+  }
+};
+
+} // namespace
+
+template<typename Controller>
+void
+run_scheduler_test(int* utest_result, std::size_t n, mamePID::SchedulerOptions options, Controller make)
+{
+  std::mt19937                           rng(7);
+  std::uniform_real_distribution<double> gain(0.0, 1.0);
+  std::uniform_real_distribution<double> target(-1.0, 1.0);
+
+  std::vector<decltype(make(0.0, 0.0, 0.0))> controllers;
+  std::vector<double>                        setpoints;
+  for ([[maybe_unused]] auto i : std::views::iota(std::size_t{ 0 }, n)) {
+    controllers.push_back(make(gain(rng), gain(rng), 0.1 * gain(rng)));
+    setpoints.push_back(target(rng));
+  }
+
+  mamePID::Scheduler scheduler(std::span<const decltype(make(0.0, 0.0, 0.0))>(controllers), options);
+  ASSERT_EQ(scheduler.size(), n);
+
+  std::vector<double> pv(n), out(n);
+  for ([[maybe_unused]] auto t : std::views::iota(0, 16)) {
+    const auto& stats = scheduler.tick(setpoints, pv, out);
+    ASSERT_EQ(stats.shards.size(), scheduler.workers());
+    std::size_t stepped = 0;
+    for (const auto& shard : stats.shards) {
+      stepped += shard.controllers;
+    }
+    ASSERT_EQ(stepped, n);
+
+    for (auto i : std::views::iota(std::size_t{ 0 }, n)) {
+      ASSERT_EQ(out[i], controllers[i].calculate(setpoints[i], pv[i]));
+    }
+    pv = out;
+  }
+}
+
+UTEST(scheduler, pid_matches_sequential)
+{
+  run_scheduler_test(utest_result, 10007, { .workers = 4 }, [](double kp, double ki, double kd) {
+    return mamePID::pid(kp, ki, kd, 0.1, -2.0, 2.0);
+  });
+}
+
+UTEST(scheduler, more_workers_than_controllers)
+{
+  run_scheduler_test(utest_result, 3, { .workers = 8, .pin = false }, [](double kp, double ki, double kd) {
+    return mamePID::i_pd(kp, ki, kd, 0.1);
+  });
+}
+
+UTEST(scheduler, small_blocks_are_stolen)
+{
+  run_scheduler_test(utest_result, 4099, { .workers = 3, .block = 5 }, [](double kp, double ki, double kd) {
+    return mamePID::pi_d(kp, ki, kd, 0.1);
+  });
+
+  // The first shard sleeps through most of the tick, so the other workers must take its blocks.
+  std::vector<Sleepy> controllers(600);
+  for (std::size_t i = 0; i < 200; ++i) {
+    controllers[i].slow = true;
+  }
+  mamePID::Scheduler  scheduler{ std::span<const Sleepy>(controllers), { .workers = 3, .block = 5 } };
+  std::vector<double> setpoints(600, 1.0), pv(600, 0.25), out(600);
+  std::size_t         stolen = 0;
+  for ([[maybe_unused]] auto t : std::views::iota(0, 4)) {
+    const auto& stats   = scheduler.tick(setpoints, pv, out);
+    std::size_t stepped = 0;
+    for (const auto& shard : stats.shards) {
+      stepped += shard.controllers;
+      stolen  += shard.stolen_blocks;
+    }
+    ASSERT_EQ(stepped, std::size_t{ 600 });
+    ASSERT_EQ(out[0], 0.75);
+  }
+  ASSERT_GT(stolen, std::size_t{ 0 });
+}
+
+UTEST(scheduler, empty)
+{
+  const std::vector<decltype(mamePID::pi(1.0, 1.0, 0.1))> controllers;
+  mamePID::Scheduler scheduler{ std::span(controllers), { .workers = 2 } };
+  const auto&        stats = scheduler.tick({}, {}, {});
+  ASSERT_EQ(stats.shards[0].controllers + stats.shards[1].controllers, std::size_t{ 0 });
+}
@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <mamePID/bank.hpp>
+#include <mamePID/fixed.hpp>
+
+#include "utest.h"
+
+using Q12 = mamePID::Fixed<std::int16_t, 12>;
+
+// Steps two identical banks, one with the scalar kernel and one with the given instruction set, and
+// requires bit-identical outputs. Inputs are wide enough to drive both the integrator and output clamps.
+template<typename T, typename Bank>
+void
+run_simd_test(int* utest_result, Bank scalar, mamePID::simd::Isa isa)
+{
+  if (!mamePID::simd::supported(isa)) {
+    return;
+  }
+
+  constexpr int n     = 67;
+  constexpr int steps = 128;
+
+  std::mt19937                      rng(7);
+  std::uniform_real_distribution<double> gain(0.0, 4.0);
+  std::uniform_real_distribution<double> signal(-2.0, 2.0);
+
+  for (auto i : std::views::iota(0, n)) {
+    const mamePID::Gains<T> gains{ T(gain(rng)), T(gain(rng)), T(gain(rng)) };
+    const auto              index = scalar.push_back(gains, T(0.001 * (i + 1)), T(-1.0), T(1.0 + i % 3));
+    if constexpr (Bank::filtered) {
+      scalar.set_filter(index, T(2 + i % 7));
+    }
+  }
+  Bank vector = scalar;
+
+  std::vector<T> setpoints(n), pvs(n), expected(n), actual(n);
+  for ([[maybe_unused]] auto step : std::views::iota(0, steps)) {
+    for (auto i : std::views::iota(0, n)) {
+      setpoints[i] = T(signal(rng));
+      pvs[i]       = T(signal(rng));
+    }
+    scalar.calculate(setpoints, pvs, expected, mamePID::simd::Isa::Scalar);
+    vector.calculate(setpoints, pvs, actual, isa);
+    ASSERT_EQ(std::memcmp(expected.data(), actual.data(), n * sizeof(T)), 0);
+  }
+}
+
+#define SIMD_TEST(factory, T, ISA)                                                                           \
+  UTEST(simd_##factory, T##_##ISA)                                                                           \
+  {                                                                                                          \
+    run_simd_test<T>(utest_result, mamePID::factory<T>(), mamePID::simd::Isa::ISA);                          \
+  }
+
+#define SIMD_FLOAT_TESTS(factory)                                                                            \
+  SIMD_TEST(factory, float, SSE2)                                                                            \
+  SIMD_TEST(factory, float, AVX2)                                                                            \
+  SIMD_TEST(factory, float, AVX512)                                                                          \
+  SIMD_TEST(factory, double, SSE2)                                                                           \
+  SIMD_TEST(factory, double, AVX2)                                                                           \
+  SIMD_TEST(factory, double, AVX512)
+
+#define SIMD_TESTS(factory)                                                                                  \
+  SIMD_FLOAT_TESTS(factory)                                                                                  \
+  SIMD_TEST(factory, Q12, AVX2)                                                                              \
+  SIMD_TEST(factory, Q12, AVX512)
+
+SIMD_TESTS(pi_bank)
+SIMD_TESTS(pd_bank)
+SIMD_TESTS(pid_bank)
+SIMD_TESTS(pi_d_bank)
+SIMD_TESTS(i_pd_bank)
+SIMD_TESTS(pid_2dof_bank)
+SIMD_FLOAT_TESTS(pid_filtered_bank)
+SIMD_FLOAT_TESTS(pi_d_filtered_bank)
+SIMD_FLOAT_TESTS(i_pd_filtered_bank)
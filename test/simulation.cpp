@@ -0,0 +1,93 @@
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+#include <mamePID/simulation.hpp>
+
+#include "utest.h"
+
+UTEST(simulation, first_order_dead_time_step)
+{
+  const auto            model = mamePID::first_order_dead_time(2.0, 0.5, 0.1, 0.01);
+  mamePID::PlantBank    plant(model, 2);
+  std::array<double, 2> u{ 1.0, -1.0 }, y{};
+  for (int k = 1; k <= 300; ++k) {
+    plant.step(u, y);
+    // y[k] is the output at t = k dt; a step held from t = 0 shows after 0.1 s of dead time.
+    const double t        = 0.01 * k - 0.1;
+    const double expected = t < 1e-9 ? 0.0 : 2.0 * (1 - std::exp(-t / 0.5));
+    ASSERT_NEAR(y[0], expected, 1e-12);
+    ASSERT_NEAR(y[1], -expected, 1e-12);
+  }
+}
+
+UTEST(simulation, second_order_step)
+{
+  const double          zeta  = 0.3;
+  const auto            model = mamePID::second_order(1.5, 10.0, zeta, 0.001);
+  mamePID::PlantBank    plant(model, 1);
+  std::array<double, 1> u{ 1.0 }, y{};
+  double                peak = 0;
+  for (int k = 0; k < 5000; ++k) {
+    plant.step(u, y);
+    peak = std::max(peak, y[0]);
+  }
+  ASSERT_NEAR(y[0], 1.5, 1e-6);
+  ASSERT_NEAR(peak / 1.5 - 1, std::exp(-std::numbers::pi * zeta / std::sqrt(1 - zeta * zeta)), 1e-3);
+}
+
+UTEST(simulation, sweep_matches_scalar_loop)
+{
+  const auto model = mamePID::first_order_dead_time(1.2, 0.3, 0.05, 0.01);
+  const std::vector<mamePID::Gains<double>> candidates{
+    { 0.5, 1.0, 0.0 }, { 1.0, 2.0, 0.01 }, { 2.0, 8.0, 0.05 }, { 4.0, 20.0, 0.0 }
+  };
+  const mamePID::SweepOptions<double> options{ .setpoint = 2.0, .steps = 400, .min = -5.0, .max = 5.0 };
+  const auto                          costs = mamePID::sweep(std::span(candidates), model, options);
+
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    const auto&           g   = candidates[i];
+    auto                  pid = mamePID::pid(g.kp, g.ki, g.kd, 0.01, -5.0, 5.0);
+    mamePID::PlantBank    plant(model, 1);
+    std::array<double, 1> u{}, y{};
+    double                iae = 0, ise = 0, itae = 0, peak = 0, settled = 0;
+    for (int k = 0; k < 400; ++k) {
+      u[0] = pid.calculate(2.0, y[0]);
+      plant.step(u, y);
+      const double t = 0.01 * (k + 1), e = 2.0 - y[0];
+      iae += std::abs(e) * 0.01;
+      ise += e * e * 0.01;
+      itae += t * std::abs(e) * 0.01;
+      peak    = std::max(peak, -e);
+      settled = 0.02 * 2.0 < std::abs(e) ? t : settled;
+    }
+    ASSERT_EQ(costs[i].iae, iae);
+    ASSERT_EQ(costs[i].ise, ise);
+    ASSERT_EQ(costs[i].itae, itae);
+    ASSERT_EQ(costs[i].overshoot, peak / 2.0);
+    ASSERT_EQ(costs[i].settling_time, settled < 4.0 ? settled : std::numeric_limits<double>::infinity());
+  }
+  // Higher gains respond faster, up to overshoot.
+  ASSERT_LT(costs[1].iae, costs[0].iae);
+  ASSERT_GT(costs[3].overshoot, 0.0);
+}
+
+UTEST(simulation, threads_do_not_change_results)
+{
+  const auto                          model = mamePID::second_order(1.0, 4.0, 0.5, 0.01);
+  std::vector<mamePID::Gains<double>> candidates;
+  for (int i = 0; i < 1000; ++i) {
+    candidates.push_back({ 0.1 + 0.01 * i, 0.5 + 0.002 * i, 0.001 * (i % 7) });
+  }
+  mamePID::SweepOptions<double> options{ .steps = 200, .threads = 1 };
+  const auto                    serial = mamePID::sweep(std::span(candidates), model, options);
+  options.threads                      = 4;
+  const auto parallel = mamePID::sweep(std::span(candidates), model, options, mamePID::pid_bank<double>);
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    ASSERT_EQ(serial[i].iae, parallel[i].iae);
+    ASSERT_EQ(serial[i].itae, parallel[i].itae);
+    ASSERT_EQ(serial[i].settling_time, parallel[i].settling_time);
+  }
+}
@@ -0,0 +1,102 @@
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+
+#include <mamePID.hpp>
+
+#include "testcases/general_i_pd.hpp"
+#include "testcases/general_pi_d.hpp"
+#include "testcases/general_pid.hpp"
+#include "testcases/simple_p.hpp"
+#include "utest.h"
+
+template<std::size_t N, typename Controller>
+constexpr std::array<double, N>
+step_response(Controller controller, double g)
+{
+  std::array<double, N> output{};
+  double                pv = 0.0;
+  for (auto& o : output) {
+    o = pv = controller.calculate(g, pv);
+  }
+  return output;
+}
+
+using pid_tc  = testcases::general_pid;
+using pi_d_tc = testcases::general_pi_d;
+using i_pd_tc = testcases::general_i_pd;
+using p_tc    = testcases::simple_p;
+
+constexpr auto static_pid =
+  step_response<32>(mamePID::pid<pid_tc::kp, pid_tc::ki, pid_tc::kd, pid_tc::sp>(), pid_tc::g);
+constexpr auto static_pi_d =
+  step_response<32>(mamePID::pi_d<pi_d_tc::kp, pi_d_tc::ki, pi_d_tc::kd, pi_d_tc::sp>(), pi_d_tc::g);
+constexpr auto static_i_pd =
+  step_response<32>(mamePID::i_pd<i_pd_tc::kp, i_pd_tc::ki, i_pd_tc::kd, i_pd_tc::sp>(), i_pd_tc::g);
+
+static_assert(
+  static_pid ==
+  step_response<32>(mamePID::pid(pid_tc::kp, pid_tc::ki, pid_tc::kd, pid_tc::sp), pid_tc::g)
+);
+static_assert(
+  static_pi_d ==
+  step_response<32>(mamePID::pi_d(pi_d_tc::kp, pi_d_tc::ki, pi_d_tc::kd, pi_d_tc::sp), pi_d_tc::g)
+);
+static_assert(
+  static_i_pd ==
+  step_response<32>(mamePID::i_pd(i_pd_tc::kp, i_pd_tc::ki, i_pd_tc::kd, i_pd_tc::sp), i_pd_tc::g)
+);
+static_assert(
+  step_response<4>(mamePID::pi<1.0, 1.0, 0.1, -0.5, 0.5>(), 1.0) == std::array{ 0.5, 0.5, 0.5, 0.5 }
+);
+
+// Only the integrator and the previous error/measurement are left in the object.
+static_assert(sizeof(mamePID::pid<0.8, 2.3, 0.05, 0.1>()) == 2 * sizeof(double));
+static_assert(sizeof(mamePID::pi<0.8, 2.3, 0.1>()) == sizeof(double));
+static_assert(sizeof(mamePID::pd<0.8, 0.0, 0.1>()) < sizeof(double));
+static_assert(sizeof(mamePID::pid<0.8f, 2.3f, 0.05f, 0.1f>()) == 2 * sizeof(float));
+
+UTEST(static, general_pid)
+{
+  for (auto i : std::views::iota(0, 32)) {
+    ASSERT_NEAR(static_pid[i], pid_tc::output[i], 1e-3);
+  }
+}
+
+UTEST(static, general_pi_d)
+{
+  for (auto i : std::views::iota(0, 32)) {
+    ASSERT_NEAR(static_pi_d[i], pi_d_tc::output[i], 1e-3);
+  }
+}
+
+UTEST(static, general_i_pd)
+{
+  for (auto i : std::views::iota(0, 32)) {
+    ASSERT_NEAR(static_i_pd[i], i_pd_tc::output[i], 1e-3);
+  }
+}
+
+UTEST(static, simple_p_drops_zero_terms)
+{
+  auto controller = mamePID::pid<p_tc::kp, p_tc::ki, p_tc::kd, p_tc::sp>();
+  static_assert(std::is_same_v<
+                decltype(controller),
+                mamePID::PID<
+                  double,
+                  mamePID::StaticProportional<double, p_tc::kp>,
+                  mamePID::Zero<double>,
+                  mamePID::Zero<double>,
+                  mamePID::StaticLimits<
+                    double,
+                    std::numeric_limits<double>::lowest(),
+                    std::numeric_limits<double>::max()>>>);
+
+  double pv = 0.0;
+  for (auto i : std::views::iota(0, 32)) {
+    pv = controller.calculate(p_tc::g, pv);
+    ASSERT_NEAR(pv, p_tc::output[i], 1e-3);
+  }
+}
@@ -0,0 +1,89 @@
+#include <memory>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <mamePID/telemetry.hpp>
+
+#include "utest.h"
+
+using Ring = mamePID::TelemetryRing<double, 1024>;
+
+UTEST(telemetry, records_terms)
+{
+  auto ring      = std::make_unique<Ring>();
+  auto traced    = mamePID::traced(mamePID::pid(0.8, 2.3, 0.05, 0.1), *ring);
+  auto reference = mamePID::pid(0.8, 2.3, 0.05, 0.1);
+
+  double pv = 0.0;
+  for ([[maybe_unused]] auto i : std::views::iota(0, 32)) {
+    const double output = traced.calculate(1.2, pv);
+    ASSERT_EQ(output, reference.calculate(1.2, pv));
+
+    const auto sample = ring->try_pop();
+    ASSERT_TRUE(sample.has_value());
+    ASSERT_EQ(sample->setpoint, 1.2);
+    ASSERT_EQ(sample->pv, pv);
+    ASSERT_EQ(sample->unclamped, sample->p + sample->i + sample->d);
+    ASSERT_EQ(sample->output, output);
+    ASSERT_EQ(sample->saturation, 0);
+    pv = output;
+  }
+  ASSERT_FALSE(ring->try_pop().has_value());
+}
+
+UTEST(telemetry, saturation_flags)
+{
+  auto ring   = std::make_unique<Ring>();
+  auto traced = mamePID::traced(mamePID::pi(1.0, 100.0, 0.1, -1.0, 1.0), *ring);
+
+  traced.calculate(5.0, 0.0);
+  auto sample = ring->try_pop();
+  ASSERT_EQ(sample->output, 1.0);
+  ASSERT_EQ(sample->saturation, mamePID::Saturation::output_high | mamePID::Saturation::integral);
+
+  traced.calculate(-5.0, 0.0);
+  sample = ring->try_pop();
+  ASSERT_EQ(sample->output, -1.0);
+  ASSERT_EQ(sample->saturation, mamePID::Saturation::output_low | mamePID::Saturation::integral);
+}
+
+UTEST(telemetry, drops_when_full)
+{
+  auto ring   = std::make_unique<mamePID::TelemetryRing<double, 4>>();
+  auto traced = mamePID::traced(mamePID::pd(1.0, 0.1, 0.1), *ring);
+  for ([[maybe_unused]] auto i : std::views::iota(0, 10)) {
+    traced.calculate(1.0, 0.0);
+  }
+  ASSERT_EQ(ring->size(), std::size_t{ 4 });
+  ASSERT_EQ(traced.dropped(), std::size_t{ 6 });
+}
+
+UTEST(telemetry, background_consumer)
+{
+  constexpr int n      = 100000;
+  auto          ring   = std::make_unique<Ring>();
+  auto          traced = mamePID::traced(mamePID::pid(0.1, 0.1, 0.0, 0.1), *ring);
+
+  std::vector<mamePID::Sample<double>> received;
+  std::atomic<bool>                    finished{ false };
+  std::thread                          consumer([&] {
+    while (!finished.load(std::memory_order_acquire) || ring->size() != 0) {
+      if (ring->drain([&](const auto& sample) { received.push_back(sample); }) == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  double pv = 0.0;
+  for ([[maybe_unused]] auto i : std::views::iota(0, n)) {
+    pv = traced.calculate(1.0, pv);
+  }
+  finished.store(true, std::memory_order_release);
+  consumer.join();
+
+  ASSERT_EQ(received.size() + traced.dropped(), std::size_t{ n });
+  for (std::size_t i = 1; i < received.size(); ++i) {
+    ASSERT_LE(received[i - 1].timestamp, received[i].timestamp);
+  }
+}
@@ -0,0 +1,111 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+
+#include <mamePID/trace.hpp>
+
+#include "utest.h"
+
+namespace {
+
+std::string
+trace_path(const char* name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+template<typename T, typename Controller>
+void
+record(const std::string& path, mamePID::Architecture architecture, Controller controller, std::size_t n)
+{
+  mamePID::TraceWriter<T> writer(path, architecture, { T(0.8), T(2.3), T(0.05) }, T(0.1), T(-5), T(5), 1000);
+  T                       pv = 0;
+  for (auto i : std::views::iota(std::size_t{ 0 }, n)) {
+    const T setpoint = i % 300 < 150 ? T(1.2) : T(-0.7);
+    const T output   = controller.calculate(setpoint, pv);
+    writer.write(setpoint, pv, output);
+    pv += T(0.5) * (output - pv);
+  }
+}
+
+template<typename T>
+void
+run_replay_test(int* utest_result, mamePID::Architecture architecture, auto controller)
+{
+  const auto path = trace_path("mamePID_trace_test.bin");
+  record<T>(path, architecture, controller, 10007);
+
+  mamePID::TraceReader<T> trace(path);
+  ASSERT_EQ(trace.size(), std::size_t{ 10007 });
+  ASSERT_EQ(trace.blocks(), std::size_t{ 11 });
+  ASSERT_TRUE(trace.header().architecture == architecture);
+  ASSERT_EQ(trace.header().kd, double(T(0.05)));
+  ASSERT_EQ(trace.block(10).size(), std::size_t{ 7 });
+
+  std::size_t replayed = 0;
+  mamePID::replay(trace, [&](const mamePID::TraceBlock<T>& block, std::span<const T> outputs) {
+    for (auto i : std::views::iota(std::size_t{ 0 }, block.size())) {
+      ASSERT_EQ(outputs[i], block.outputs[i]);
+    }
+    replayed += block.size();
+  });
+  ASSERT_EQ(replayed, std::size_t{ 10007 });
+  std::filesystem::remove(path);
+}
+
+} // namespace
+
+UTEST(trace, replay_pid)
+{
+  run_replay_test<double>(
+    utest_result, mamePID::Architecture::PID, mamePID::pid(0.8, 2.3, 0.05, 0.1, -5.0, 5.0)
+  );
+}
+
+UTEST(trace, replay_pi_d_float)
+{
+  run_replay_test<float>(
+    utest_result, mamePID::Architecture::PI_D, mamePID::pi_d(0.8f, 2.3f, 0.05f, 0.1f, -5.0f, 5.0f)
+  );
+}
+
+UTEST(trace, replay_i_pd)
+{
+  run_replay_test<double>(
+    utest_result, mamePID::Architecture::I_PD, mamePID::i_pd(0.8, 2.3, 0.05, 0.1, -5.0, 5.0)
+  );
+}
+
+UTEST(trace, rejects_mismatched_files)
+{
+  const auto path = trace_path("mamePID_trace_reject.bin");
+  record<float>(path, mamePID::Architecture::PID, mamePID::pid(0.8f, 2.3f, 0.05f, 0.1f), 10);
+  ASSERT_EXCEPTION(mamePID::TraceReader<double>{ path }, std::runtime_error);
+
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+  ASSERT_EXCEPTION(mamePID::TraceReader<float>{ path }, std::runtime_error);
+
+  // Headers with an unknown architecture or a sample count far beyond the file size.
+  const auto patch = [&](std::streamoff offset, auto value) {
+    record<float>(path, mamePID::Architecture::PID, mamePID::pid(0.8f, 2.3f, 0.05f, 0.1f), 10);
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  patch(offsetof(mamePID::TraceHeader, architecture), std::uint32_t{ 7 });
+  ASSERT_EXCEPTION(mamePID::TraceReader<float>{ path }, std::runtime_error);
+  patch(offsetof(mamePID::TraceHeader, samples), std::uint64_t{ 0x5555555555555556 });
+  ASSERT_EXCEPTION(mamePID::TraceReader<float>{ path }, std::runtime_error);
+
+  const mamePID::Gains<float> gains{ 1.0f, 0.0f, 0.0f };
+  const auto                  unknown = mamePID::Architecture(3);
+  ASSERT_EXCEPTION(mamePID::TraceWriter<float>(path, unknown, gains, 0.1f), std::invalid_argument);
+
+  std::ofstream(path, std::ios::binary) << "not a trace";
+  ASSERT_EXCEPTION(mamePID::TraceReader<float>{ path }, std::runtime_error);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,139 @@
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <mamePID/tune.hpp>
+
+#include "utest.h"
+
+namespace {
+
+// Ultimate gain and period of K exp(-theta s) / (tau s + 1): the frequency where the phase reaches -pi.
+mamePID::Ultimate<double>
+fopdt_ultimate(double k, double tau, double theta)
+{
+  double w = 1.0;
+  for (int i = 0; i < 50; ++i) {
+    const double f = std::atan(w * tau) + w * theta - std::numbers::pi;
+    w -= f / (tau / (1 + w * w * tau * tau) + theta);
+  }
+  return { std::sqrt(1 + w * w * tau * tau) / k, 2 * std::numbers::pi / w };
+}
+
+} // namespace
+
+UTEST(tune, relay_finds_ultimate_point)
+{
+  const auto            model = mamePID::first_order_dead_time(2.0, 1.0, 0.2, 0.001);
+  mamePID::PlantBank    plant(model, 1);
+  std::array<double, 1> u{}, y{};
+  const auto            ultimate = mamePID::relay_feedback(
+    [&](double input) {
+      u[0] = input;
+      plant.step(u, y);
+      return y[0];
+    },
+    0.5,
+    0.0,
+    0.001,
+    20000
+  );
+  // The output is far from a sine here; its peak would underestimate the ultimate gain by about 20%.
+  const auto expected = fopdt_ultimate(2.0, 1.0, 0.2);
+  ASSERT_NEAR(ultimate.period, expected.period, 0.02 * expected.period);
+  ASSERT_NEAR(ultimate.gain, expected.gain, 0.03 * expected.gain);
+}
+
+UTEST(tune, relay_failures_throw)
+{
+  // A decaying response never crosses its center twice in the second half.
+  std::vector<double>           y(1000);
+  const std::span<const double> samples(y);
+  for (std::size_t k = 0; k < y.size(); ++k) {
+    y[k] = std::exp(-0.01 * double(k));
+  }
+  ASSERT_EXCEPTION(mamePID::ultimate_from_relay(samples, 1.0, 0.0, 0.01), std::runtime_error);
+  ASSERT_EXCEPTION(mamePID::ultimate_from_relay(samples.first(3), 1.0, 0.0, 0.01), std::runtime_error);
+
+  // An oscillation smaller than the hysteresis.
+  for (std::size_t k = 0; k < y.size(); ++k) {
+    y[k] = 0.1 * std::sin(0.1 * double(k));
+  }
+  ASSERT_EXCEPTION(mamePID::ultimate_from_relay(samples, 1.0, 0.5, 0.01), std::runtime_error);
+}
+
+UTEST(tune, identify_step_recovers_fopdt)
+{
+  const auto            model = mamePID::first_order_dead_time(1.5, 0.8, 0.3, 0.01);
+  mamePID::PlantBank    plant(model, 1);
+  std::array<double, 1> u{ 2.0 }, y{};
+  std::vector<double>   response{ 0.0 };
+  for (int k = 0; k < 1000; ++k) {
+    plant.step(u, y);
+    response.push_back(y[0]);
+  }
+  const auto fit = mamePID::identify_step(std::span<const double>(response), 2.0, 0.01);
+  ASSERT_NEAR(fit.gain, 1.5, 1e-3);
+  ASSERT_NEAR(fit.tau, 0.8, 0.02);
+  ASSERT_NEAR(fit.theta, 0.3, 0.02);
+}
+
+UTEST(tune, rules)
+{
+  const auto zn = mamePID::ziegler_nichols(mamePID::Ultimate<double>{ 10.0, 2.0 });
+  ASSERT_NEAR(zn.kp, 6.0, 1e-12);
+  ASSERT_NEAR(zn.ki, 6.0, 1e-12);
+  ASSERT_NEAR(zn.kd, 1.5, 1e-12);
+  const auto zn_pi = mamePID::ziegler_nichols_pi(mamePID::Ultimate<double>{ 10.0, 2.0 });
+  ASSERT_NEAR(zn_pi.kp, 4.5, 1e-12);
+  ASSERT_NEAR(zn_pi.ki, 2.7, 1e-12);
+  ASSERT_EQ(zn_pi.kd, 0.0);
+
+  const auto pid = mamePID::imc(mamePID::Fopdt<double>{ 2.0, 1.0, 0.2 }, 0.5);
+  ASSERT_NEAR(pid.kp, 2.2 / (2.0 * 1.2), 1e-12);
+  ASSERT_NEAR(pid.ki, pid.kp / 1.1, 1e-12);
+  ASSERT_NEAR(pid.kd, pid.kp * 0.2 / 2.2, 1e-12);
+  const auto pi = mamePID::imc_pi(mamePID::Fopdt<double>{ 2.0, 1.0, 0.2 }, 0.5);
+  ASSERT_NEAR(pi.kp, 1.0 / 1.4, 1e-12);
+  ASSERT_NEAR(pi.ki, pi.kp / 1.0, 1e-12);
+}
+
+UTEST(tune, refine_improves_on_the_rule)
+{
+  const mamePID::Fopdt<double> plant{ 1.2, 0.5, 0.1 };
+  const auto                   model = plant.model(0.01);
+
+  mamePID::TuneOptions<double> options;
+  options.simulation    = { .steps = 300, .min = -10.0, .max = 10.0 };
+  options.max_overshoot = 0.05;
+
+  const auto initial = mamePID::imc(plant, 0.5);
+  const auto tuned   = mamePID::refine(initial, model, options);
+
+  const auto baseline = mamePID::sweep(std::span(&initial, 1), model, options.simulation);
+  ASSERT_LT(tuned.objective, baseline[0].itae);
+  ASSERT_LE(tuned.cost.overshoot, 0.05);
+  ASSERT_GT(tuned.evaluations, 100u);
+
+  // The reported cost is the cost of the returned gains.
+  const auto check = mamePID::sweep(std::span(&tuned.gains, 1), model, options.simulation);
+  ASSERT_EQ(check[0].itae, tuned.cost.itae);
+}
+
+UTEST(tune, refine_keeps_structure)
+{
+  const mamePID::Fopdt<double> plant{ 1.0, 1.0, 0.2 };
+  mamePID::TuneOptions<double> options;
+  // A block below the 16 candidates the refinement cuts batches into.
+  options.simulation = { .steps = 400, .block = 8 };
+  options.iterations = 10;
+
+  const auto initial = mamePID::imc_pi(plant, 0.4);
+  const auto tuned   = mamePID::refine(initial, plant.model(0.01), options, mamePID::i_pd_bank<double>);
+  ASSERT_EQ(tuned.gains.kd, 0.0);
+  ASSERT_GT(tuned.gains.kp, 0.0);
+  ASSERT_GT(tuned.gains.ki, 0.0);
+}
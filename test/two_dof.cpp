@@ -0,0 +1,102 @@
+#include <array>
+#include <cmath>
+#include <ranges>
+#include <vector>
+
+#include <mamePID/bank.hpp>
+
+#include "testcases/general_i_pd.hpp"
+#include "testcases/general_pi_d.hpp"
+#include "testcases/general_pid.hpp"
+#include "utest.h"
+
+template<typename TC>
+void
+run_2dof_step_response(int* utest_result, double b, double c)
+{
+  auto   controller = mamePID::pid_2dof(TC::kp, TC::ki, TC::kd, b, c, TC::sp);
+  double pv         = 0;
+  for (auto i : std::views::iota(0, static_cast<int>(TC::output.size()))) {
+    pv = controller.calculate(TC::g, pv);
+    ASSERT_NEAR(pv, TC::output[i], 1e-9 + 1e-12 * std::abs(TC::output[i]));
+  }
+}
+
+UTEST(two_dof, general_pid)
+{
+  run_2dof_step_response<testcases::general_pid>(utest_result, 1.0, 1.0);
+}
+
+UTEST(two_dof, general_pi_d)
+{
+  run_2dof_step_response<testcases::general_pi_d>(utest_result, 1.0, 0.0);
+}
+
+UTEST(two_dof, general_i_pd)
+{
+  run_2dof_step_response<testcases::general_i_pd>(utest_result, 0.0, 0.0);
+}
+
+// The weights reproduce the dedicated compositions bit for bit, including output and integral clamps.
+UTEST(two_dof, matches_fixed_architectures)
+{
+  auto pid       = mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto pi_d      = mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto i_pd      = mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0);
+  auto pid_2dof  = mamePID::pid_2dof(0.8, 2.3, 0.05, 1.0, 1.0, 0.01, -1.0, 1.0);
+  auto pi_d_2dof = mamePID::pid_2dof(0.8, 2.3, 0.05, 1.0, 0.0, 0.01, -1.0, 1.0);
+  auto i_pd_2dof = mamePID::pid_2dof(0.8, 2.3, 0.05, 0.0, 0.0, 0.01, -1.0, 1.0);
+  for (auto i : std::views::iota(0, 200)) {
+    const double setpoint = i < 100 ? 3.0 : -0.5;
+    const double pv       = std::sin(0.2 * i);
+    ASSERT_EQ(pid_2dof.calculate(setpoint, pv), pid.calculate(setpoint, pv));
+    ASSERT_EQ(pi_d_2dof.calculate(setpoint, pv), pi_d.calculate(setpoint, pv));
+    ASSERT_EQ(i_pd_2dof.calculate(setpoint, pv), i_pd.calculate(setpoint, pv));
+  }
+}
+
+UTEST(two_dof, set_weights)
+{
+  auto a = mamePID::pid_2dof(0.8, 2.3, 0.05, 1.0, 1.0, 0.01);
+  auto b = mamePID::pid_2dof(0.8, 2.3, 0.05, 0.5, 0.25, 0.01);
+  a.setWeights({ 0.5, 0.25 });
+  for (auto i : std::views::iota(0, 32)) {
+    ASSERT_EQ(a.calculate(1.0, 0.1 * i), b.calculate(1.0, 0.1 * i));
+  }
+}
+
+// One weighted bank stepping PID, PI-D, I-PD and intermediate loops side by side.
+UTEST(two_dof, heterogeneous_bank)
+{
+  using mamePID::simd::Isa;
+  using Controller = decltype(mamePID::pid_2dof(0.0, 0.0, 0.0, 0.0, 0.0, 0.0));
+
+  constexpr std::size_t                         n = 37;
+  const std::array<mamePID::Weights<double>, 4> weights{
+    { { 1.0, 1.0 }, { 1.0, 0.0 }, { 0.0, 0.0 }, { 0.6, 0.3 } }
+  };
+  for (auto isa : { Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512 }) {
+    if (!mamePID::simd::supported(isa)) {
+      continue;
+    }
+    auto                    bank = mamePID::pid_2dof_bank<double>();
+    std::vector<Controller> scalar;
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto& w = weights[i % weights.size()];
+      bank.push_back({ 0.8, 2.3, 0.05 }, w, 0.01, -2.0, 2.0);
+      scalar.push_back(mamePID::pid_2dof(0.8, 2.3, 0.05, w.b, w.c, 0.01, -2.0, 2.0));
+    }
+
+    std::vector<double> setpoints(n), pvs(n), out(n);
+    for (auto step : std::views::iota(0, 64)) {
+      for (std::size_t i = 0; i < n; ++i) {
+        setpoints[i] = std::cos(0.1 * step + i);
+        pvs[i]       = std::sin(0.3 * step - i);
+      }
+      bank.calculate(setpoints, pvs, out, isa);
+      for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(out[i], scalar[i].calculate(setpoints[i], pvs[i]));
+      }
+    }
+  }
+}
@@ -0,0 +1,117 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <ranges>
+
+#include <mamePID.hpp>
+#include <mamePID/fixed.hpp>
+#include <mamePID/timed.hpp>
+
+#include "utest.h"
+
+static_assert(mamePID::VariableStep<mamePID::Integral<double>>);
+static_assert(mamePID::VariableStep<mamePID::StaticDerivative<double, 0.05, 0.01>>);
+static_assert(mamePID::VariableStepController<decltype(mamePID::pid<0.8, 2.3, 0.05, 0.01>())>);
+
+// Passing the nominal period must not change a single bit of the result.
+template<typename Controller>
+void
+run_nominal_step(int* utest_result, Controller controller, double dt)
+{
+  auto reference = controller;
+  for (auto i : std::views::iota(0, 64)) {
+    const double setpoint = i < 32 ? 1.2 : -0.7;
+    const double pv       = std::sin(0.3 * i);
+    ASSERT_EQ(controller.calculate(setpoint, pv, dt), reference.calculate(setpoint, pv));
+  }
+}
+
+UTEST(variable_step, nominal_dt_matches_fixed_path)
+{
+  run_nominal_step(utest_result, mamePID::pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0), 0.01);
+  run_nominal_step(utest_result, mamePID::pi_d(0.8, 2.3, 0.05, 0.01, -1.0, 1.0), 0.01);
+  run_nominal_step(utest_result, mamePID::i_pd(0.8, 2.3, 0.05, 0.01, -1.0, 1.0), 0.01);
+  run_nominal_step(utest_result, mamePID::pi<mamePID::ConditionalIntegral>(0.8, 2.3, 0.01, -1.0, 1.0), 0.01);
+  run_nominal_step(utest_result, mamePID::velocity_pid(0.8, 2.3, 0.05, 0.01, -1.0, 1.0), 0.01);
+  run_nominal_step(utest_result, mamePID::pid<0.8, 2.3, 0.05, 0.01, -1.0, 1.0>(), 0.01);
+  run_nominal_step(utest_result, mamePID::i_pd<0.8, 2.3, 0.05, 0.01, -1.0, 1.0>(), 0.01);
+}
+
+// Periods of half and four times the nominal one against the same component in double, built from the
+// rounded Q15 gains so that only the arithmetic differs.
+template<template<typename> typename Component, typename... Weights>
+void
+run_fixed_variable_step(int* utest_result, double gain, double dt, Weights... weights)
+{
+  using mamePID::Q15;
+  Component<Q15>    fixed{ Q15(gain), Q15(dt), Q15(weights)... };
+  Component<double> reference{ double(Q15(gain)), double(Q15(dt)), double(Q15(weights))... };
+  for (auto i : std::views::iota(0, 64)) {
+    const Q15 period(i % 2 == 0 ? 0.5 * dt : 4.0 * dt);
+    const Q15 pv(0.4 * std::sin(0.3 * i));
+    const Q15 output = fixed.calculate(Q15(0.5), pv, period);
+    ASSERT_NEAR(double(output), reference.calculate(double(Q15(0.5)), double(pv), double(period)), 1e-3);
+  }
+}
+
+UTEST(variable_step, fixed_point_periods)
+{
+  run_fixed_variable_step<mamePID::Derivative>(utest_result, 0.001, 0.01);
+  run_fixed_variable_step<mamePID::PrecedingDerivative>(utest_result, 0.001, 0.01);
+  run_fixed_variable_step<mamePID::WeightedDerivative>(utest_result, 0.001, 0.01, 0.5);
+  run_fixed_variable_step<mamePID::VelocityIntegral>(utest_result, 0.5, 0.01);
+  run_fixed_variable_step<mamePID::VelocityDerivative>(utest_result, 0.001, 0.01);
+  run_fixed_variable_step<mamePID::VelocityPrecedingDerivative>(utest_result, 0.001, 0.01);
+}
+
+UTEST(variable_step, jittered_samples)
+{
+  const double kp = 0.8, ki = 2.3, kd = 0.05;
+  auto         pid = mamePID::pid(kp, ki, kd, 0.01);
+
+  std::minstd_rand                       rng(5);
+  std::uniform_real_distribution<double> jitter(0.005, 0.015);
+  double                                 integral = 0, pre_error = 0;
+  for (auto i : std::views::iota(0, 256)) {
+    const double dt       = jitter(rng);
+    const double error    = 1.0 - std::cos(0.05 * i);
+    integral             += ki * dt * error;
+    const double expected = kp * error + integral + kd * (error - pre_error) / dt;
+    pre_error             = error;
+    ASSERT_NEAR(pid.calculate(1.0, std::cos(0.05 * i), dt), expected, 1e-12);
+  }
+}
+
+// The velocity derivative differences consecutive derivative terms, so it still telescopes to the
+// positional form when the period changes from one sample to the next.
+UTEST(variable_step, velocity_matches_positional)
+{
+  auto positional = mamePID::i_pd(0.8, 2.3, 0.05, 0.01);
+  auto velocity   = mamePID::velocity_i_pd(0.8, 2.3, 0.05, 0.01);
+
+  std::minstd_rand                       rng(9);
+  std::uniform_real_distribution<double> jitter(0.005, 0.015);
+  for (auto i : std::views::iota(0, 256)) {
+    const double dt = jitter(rng);
+    const double pv = std::sin(0.1 * i);
+    ASSERT_NEAR(velocity.calculate(1.0, pv, dt), positional.calculate(1.0, pv, dt), 1e-9);
+  }
+}
+
+UTEST(variable_step, timed)
+{
+  using namespace std::chrono_literals;
+  const std::chrono::steady_clock::time_point t0{};
+
+  auto timed     = mamePID::timed(mamePID::pid(0.8, 2.3, 0.05, 0.01));
+  auto reference = mamePID::pid(0.8, 2.3, 0.05, 0.01);
+
+  ASSERT_EQ(timed.calculate(1.0, 0.0, t0), reference.calculate(1.0, 0.0));
+  ASSERT_EQ(timed.calculate(1.0, 0.1, t0 + 20ms), reference.calculate(1.0, 0.1, 0.02));
+  ASSERT_EQ(timed.calculate(1.0, 0.2, t0 + 20ms), timed.calculate(1.0, 0.3, t0 + 15ms));
+  ASSERT_EQ(timed.calculate(1.0, 0.2, t0 + 25ms), reference.calculate(1.0, 0.2, 0.005));
+
+  timed.restart();
+  ASSERT_EQ(timed.calculate(1.0, 0.4, t0 + 1s), reference.calculate(1.0, 0.4));
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <ranges>
+
+#include <mamePID.hpp>
+
+#include "testcases/general_i_pd.hpp"
+#include "testcases/general_pi_d.hpp"
+#include "testcases/general_pid.hpp"
+#include "testcases/simple_pd.hpp"
+#include "testcases/simple_pi.hpp"
+#include "testcases/velocity_i_pd.hpp"
+#include "testcases/velocity_pi_d.hpp"
+#include "testcases/velocity_pid.hpp"
+#include "utest.h"
+
+template<typename TC, typename Controller>
+void
+run_velocity_step_response(int* utest_result, Controller controller)
+{
+  double pv = 0;
+  for (auto i : std::views::iota(0, static_cast<int>(TC::output.size()))) {
+    pv = controller.calculate(TC::g, pv);
+    ASSERT_NEAR(pv, TC::output[i], 1e-9 + 1e-12 * std::abs(TC::output[i]));
+  }
+}
+
+// Without limits the velocity form telescopes to the positional one, so it reproduces those vectors.
+UTEST(velocity, unclamped_matches_positional)
+{
+  using namespace testcases;
+  auto pi = mamePID::velocity_pi(simple_pi::kp, simple_pi::ki, simple_pi::sp);
+  run_velocity_step_response<simple_pi>(utest_result, pi);
+
+  auto pd = mamePID::velocity_pd(simple_pd::kp, simple_pd::kd, simple_pd::sp);
+  run_velocity_step_response<simple_pd>(utest_result, pd);
+
+  auto pid = mamePID::velocity_pid(general_pid::kp, general_pid::ki, general_pid::kd, general_pid::sp);
+  run_velocity_step_response<general_pid>(utest_result, pid);
+
+  auto pi_d = mamePID::velocity_pi_d(general_pi_d::kp, general_pi_d::ki, general_pi_d::kd, general_pi_d::sp);
+  run_velocity_step_response<general_pi_d>(utest_result, pi_d);
+
+  auto i_pd = mamePID::velocity_i_pd(general_i_pd::kp, general_i_pd::ki, general_i_pd::kd, general_i_pd::sp);
+  run_velocity_step_response<general_i_pd>(utest_result, i_pd);
+}
+
+UTEST(velocity, velocity_pid)
+{
+  using TC        = testcases::velocity_pid;
+  auto controller = mamePID::velocity_pid(TC::kp, TC::ki, TC::kd, TC::sp, TC::minv, TC::maxv);
+  run_velocity_step_response<TC>(utest_result, controller);
+}
+
+UTEST(velocity, velocity_pi_d)
+{
+  using TC        = testcases::velocity_pi_d;
+  auto controller = mamePID::velocity_pi_d(TC::kp, TC::ki, TC::kd, TC::sp, TC::minv, TC::maxv);
+  run_velocity_step_response<TC>(utest_result, controller);
+}
+
+UTEST(velocity, velocity_i_pd)
+{
+  using TC        = testcases::velocity_i_pd;
+  auto controller = mamePID::velocity_i_pd(TC::kp, TC::ki, TC::kd, TC::sp, TC::minv, TC::maxv);
+  run_velocity_step_response<TC>(utest_result, controller);
+}
+
+// Held at the limit for a long time, the output still moves off it on the first update with a reversed
+// error.
+UTEST(velocity, no_windup)
+{
+  auto pi = mamePID::velocity_pi(0.5, 1.0, 0.1, -1.0, 1.0);
+  for ([[maybe_unused]] auto i : std::views::iota(0, 1000)) {
+    ASSERT_EQ(pi.calculate(10.0, 0.0), 1.0);
+  }
+  ASSERT_LT(pi.calculate(-0.5, 0.0), 1.0);
+}
+
+UTEST(velocity, bumpless_transfer)
+{
+  auto pid = mamePID::velocity_pid(0.8, 2.3, 0.05, 0.01, -10.0, 10.0);
+  pid.track(3.5);
+  ASSERT_EQ(pid.output(), 3.5);
+  ASSERT_EQ(pid.calculate(1.0, 1.0), 3.5);
+
+  pid.track(20.0);
+  ASSERT_EQ(pid.output(), 10.0);
+}
@@ -0,0 +1,175 @@
+// Command line front end of the reference simulator.
+//
+//   refsim <name> [--arch PID|PI_D|I_PD] [--kp v] [--ki v] [--kd v] [--g v] [--sp v] [--n v]
+//                 [--minv v] [--maxv v] [--form positional|velocity]
+//     Prints one test vector as a C++ header, in the layout of tools/gen_testcases. Finite limits are
+//     included as minv and maxv.
+//
+//   refsim --random <cases> [--n v] [--seed v] [--threads v]
+//     Simulates random cases in parallel and prints one CSV row per case:
+//     arch,kp,ki,kd,g,sp,y0,y1,...
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "refsim.hpp"
+
+namespace {
+
+[[noreturn]] void
+usage(const char* message)
+{
+  std::fprintf(stderr, "refsim: %s\n", message);
+  std::exit(1);
+}
+
+double
+to_double(std::string_view text)
+{
+  double value = 0;
+  if (std::from_chars(text.data(), text.data() + text.size(), value).ec != std::errc{}) {
+    usage("invalid number");
+  }
+  return value;
+}
+
+// Shortest text that reads back as the same double, as Python's repr prints it.
+std::string
+shortest(double value)
+{
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  std::string text(buffer, result.ptr);
+  if (text.find_first_of(".en") == std::string::npos) {
+    text += ".0";
+  }
+  return text;
+}
+
+void
+print_header(const std::string& name, const refsim::Case& c, const std::vector<refsim::Real>& y)
+{
+  std::printf("#include<array>\n\n");
+  std::printf("namespace testcases {\n");
+  std::printf("    struct %s {\n", name.c_str());
+  std::printf("        static constexpr const char* arch{\"%s\"};\n", refsim::to_string(c.arch));
+  std::printf("        static constexpr double kp{%s};\n", shortest(c.kp).c_str());
+  std::printf("        static constexpr double ki{%s};\n", shortest(c.ki).c_str());
+  std::printf("        static constexpr double kd{%s};\n", shortest(c.kd).c_str());
+  std::printf("        static constexpr double g{%s};\n", shortest(c.g).c_str());
+  std::printf("        static constexpr double sp{%s};\n", shortest(c.sp).c_str());
+  if (std::isfinite(c.minv)) {
+    std::printf("        static constexpr double minv{%s};\n", shortest(c.minv).c_str());
+  }
+  if (std::isfinite(c.maxv)) {
+    std::printf("        static constexpr double maxv{%s};\n", shortest(c.maxv).c_str());
+  }
+  std::printf("    \n");
+  std::printf("        static constexpr std::array<double, %zu> output{\n            ", y.size());
+  for (std::size_t i = 0; i < y.size(); ++i) {
+    std::printf("%s%s", i == 0 ? "" : ",", shortest(static_cast<double>(y[i])).c_str());
+  }
+  std::printf("\n        };\n    };\n}\n");
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    usage("missing testcase name or --random");
+  }
+
+  refsim::Case  c;
+  std::size_t   random_cases = 0;
+  std::uint64_t seed         = 1;
+  unsigned      threads      = std::thread::hardware_concurrency();
+  std::string   name;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    if (!arg.starts_with("--")) {
+      name = arg;
+      continue;
+    }
+    if (i + 1 == argc) {
+      usage("missing option value");
+    }
+    const std::string_view value(argv[++i]);
+    if (arg == "--arch") {
+      const auto arch = refsim::parse_architecture(value);
+      if (!arch) {
+        usage("unknown architecture");
+      }
+      c.arch = *arch;
+    } else if (arg == "--kp") {
+      c.kp = to_double(value);
+    } else if (arg == "--ki") {
+      c.ki = to_double(value);
+    } else if (arg == "--kd") {
+      c.kd = to_double(value);
+    } else if (arg == "--g") {
+      c.g = to_double(value);
+    } else if (arg == "--sp") {
+      c.sp = to_double(value);
+    } else if (arg == "--n") {
+      c.n = static_cast<std::size_t>(to_double(value));
+    } else if (arg == "--minv") {
+      c.minv = to_double(value);
+    } else if (arg == "--maxv") {
+      c.maxv = to_double(value);
+    } else if (arg == "--form") {
+      if (value != "positional" && value != "velocity") {
+        usage("unknown form");
+      }
+      c.velocity = value == "velocity";
+    } else if (arg == "--random") {
+      random_cases = static_cast<std::size_t>(to_double(value));
+    } else if (arg == "--seed") {
+      seed = static_cast<std::uint64_t>(to_double(value));
+    } else if (arg == "--threads") {
+      threads = static_cast<unsigned>(to_double(value));
+    } else {
+      usage("unknown option");
+    }
+  }
+
+  if (random_cases == 0) {
+    if (name.empty()) {
+      usage("missing testcase name");
+    }
+    print_header(name, c, refsim::simulate(c));
+    return 0;
+  }
+
+  const auto                     cases = refsim::random_cases(random_cases, c.n, seed);
+  std::vector<std::vector<refsim::Real>> responses(cases.size());
+  refsim::parallel_for(cases.size(), threads, [&](std::size_t i) {
+    responses[i] = refsim::simulate(cases[i]);
+  });
+
+  for (std::size_t i = 0; i < cases.size(); ++i) {
+    const auto& k = cases[i];
+    std::printf(
+      "%s,%s,%s,%s,%s,%s",
+      refsim::to_string(k.arch),
+      shortest(k.kp).c_str(),
+      shortest(k.ki).c_str(),
+      shortest(k.kd).c_str(),
+      shortest(k.g).c_str(),
+      shortest(k.sp).c_str()
+    );
+    for (auto y : responses[i]) {
+      std::printf(",%s", shortest(static_cast<double>(y)).c_str());
+    }
+    std::printf("\n");
+  }
+  return 0;
+}
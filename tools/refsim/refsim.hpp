@@ -0,0 +1,296 @@
+#ifndef MAMEPID_TOOLS_REFSIM_HPP_
+#define MAMEPID_TOOLS_REFSIM_HPP_
+
+// Reference simulator for the closed loops that tools/gen_testcases derives with sympy: the controller C(s)
+// in feedback with a unit delay, behind the architecture's feedforward filter F(s),
+//
+//   Y/R = F C / (1 + C z^-1),  C(s) = (kd s^2 + kp s + ki) / s,
+//
+// discretized with the backward difference s = (1 - z^-1) / sp and stepped as a difference equation in
+// long double. It does not share code with mamePID, so the two can be compared.
+//
+// Velocity-form cases are stepped in the time domain instead, because the output clamp sits inside their
+// loop: u[k] = clamp(u[k-1] + du[k]) with du the increment of the architecture's positional law.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace refsim {
+
+using Real = long double;
+
+enum class Architecture
+{
+  PID,
+  PI_D,
+  I_PD,
+};
+
+inline constexpr Architecture architectures[] = { Architecture::PID, Architecture::PI_D, Architecture::I_PD };
+
+constexpr const char*
+to_string(Architecture arch)
+{
+  switch (arch) {
+    case Architecture::PID:
+      return "PID";
+    case Architecture::PI_D:
+      return "PI_D";
+    case Architecture::I_PD:
+      return "I_PD";
+  }
+  return "";
+}
+
+inline std::optional<Architecture>
+parse_architecture(std::string_view text)
+{
+  for (auto arch : architectures) {
+    if (text == to_string(arch)) {
+      return arch;
+    }
+  }
+  return std::nullopt;
+}
+
+struct Case
+{
+  Architecture arch     = Architecture::PID;
+  double       kp       = 1.0;
+  double       ki       = 0.0;
+  double       kd       = 0.0;
+  double       g        = 1.0;
+  double       sp       = 0.01;
+  std::size_t  n        = 32;
+  double       minv     = -std::numeric_limits<double>::infinity();
+  double       maxv     = std::numeric_limits<double>::infinity();
+  bool         velocity = false;
+};
+
+// Polynomial in q = z^-1, lowest power first.
+using Polynomial = std::vector<Real>;
+
+inline Polynomial
+operator*(const Polynomial& a, const Polynomial& b)
+{
+  Polynomial c(a.size() + b.size() - 1, 0);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    for (std::size_t j = 0; j < b.size(); ++j) {
+      c[i + j] += a[i] * b[j];
+    }
+  }
+  return c;
+}
+
+inline Polynomial
+operator+(Polynomial a, const Polynomial& b)
+{
+  a.resize(std::max(a.size(), b.size()), 0);
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    a[i] += b[i];
+  }
+  return a;
+}
+
+struct TransferFunction
+{
+  Polynomial num;
+  Polynomial den;
+};
+
+// c2 s^2 + c1 s + c0 with s = (1 - q) / sp, multiplied by sp^2.
+inline Polynomial
+quadratic(Real c2, Real c1, Real c0, Real sp)
+{
+  return { c2 + c1 * sp + c0 * sp * sp, -2 * c2 - c1 * sp, c2 };
+}
+
+inline TransferFunction
+closed_loop(const Case& c)
+{
+  const Real sp = c.sp, kp = c.kp, ki = c.ki, kd = c.kd;
+
+  // C = nc / dc, both scaled by sp^2.
+  const Polynomial nc = quadratic(kd, kp, ki, sp);
+  const Polynomial dc = { sp, -sp };
+
+  // F = nf / df, both scaled by sp^2.
+  Polynomial nf = { 1 }, df = { 1 };
+  if (c.arch == Architecture::PI_D) {
+    nf = quadratic(0, kp, ki, sp);
+    df = quadratic(kd, kp, ki, sp);
+  } else if (c.arch == Architecture::I_PD) {
+    nf = quadratic(0, 0, ki, sp);
+    df = quadratic(kd, kp, ki, sp);
+  }
+
+  return { nf * nc, df * (dc + Polynomial{ 0, 1 } * nc) };
+}
+
+// Control law stepped in the time domain on setpoints r and process values y. The P and D terms see the
+// weighted setpoints b r and c r: b = c = 1 is PID, b = 1, c = 0 PI_D and b = c = 0 I_PD. The positional
+// form is
+//
+//   u = clamp(kp (b r - y) + I + D),  I = clamp(I + ki sp (r - y)),
+//   D = (tf D + kd (e - e')) / (tf + sp),  e = c r - y,  tf = kd / (kp n),
+//
+// the backward difference of kd s / (1 + tf s); n = infinity or kp = 0 leaves kd / sp (e - e'). The
+// velocity form adds the increment of the unfiltered law, without the clamps, to its clamped previous
+// output: u = clamp(u' + kp (b (r - r') - (y - y')) + ki sp (r - y) + kd / sp (e - 2 e' + e'')).
+struct Law
+{
+  Real kp       = 1;
+  Real ki       = 0;
+  Real kd       = 0;
+  Real sp       = 0.01;
+  Real b        = 1;
+  Real c        = 1;
+  Real n        = std::numeric_limits<Real>::infinity();
+  Real minv     = -std::numeric_limits<Real>::infinity();
+  Real maxv     = std::numeric_limits<Real>::infinity();
+  bool velocity = false;
+};
+
+inline Law
+law(const Case& c)
+{
+  const Real b = c.arch == Architecture::I_PD ? 0 : 1;
+  const Real d = c.arch == Architecture::PID ? 1 : 0;
+  return { c.kp, c.ki, c.kd, c.sp, b, d, std::numeric_limits<Real>::infinity(), c.minv, c.maxv, c.velocity };
+}
+
+class Controller
+{
+public:
+  explicit Controller(const Law& law)
+    : law(law)
+    , tf(law.kp == 0 || std::isinf(law.n) ? 0 : law.kd / (law.kp * law.n))
+    , u(std::clamp<Real>(0, law.minv, law.maxv))
+  {
+  }
+
+  Real step(Real r, Real y)
+  {
+    const Real p = law.kp * (law.b * r - y);
+    const Real e = law.c * r - y;
+    if (law.velocity) {
+      const Real i = law.ki * law.sp * (r - y);
+      const Real d = law.kd / law.sp * (e - 2 * e1 + e2);
+      u            = std::clamp<Real>(u + (p - p1) + i + d, law.minv, law.maxv);
+    } else {
+      integral   = std::clamp<Real>(integral + law.ki * law.sp * (r - y), law.minv, law.maxv);
+      derivative = (tf * derivative + law.kd * (e - e1)) / (tf + law.sp);
+      u          = std::clamp<Real>(p + integral + derivative, law.minv, law.maxv);
+    }
+    p1 = p;
+    e2 = e1;
+    e1 = e;
+    return u;
+  }
+
+private:
+  Law  law;
+  Real tf;
+  Real u;
+  Real integral   = 0;
+  Real derivative = 0;
+  Real p1         = 0;
+  Real e1         = 0;
+  Real e2         = 0;
+};
+
+// Step response of the velocity form, with the process value of step k being the output of step k - 1.
+inline std::vector<Real>
+simulate_velocity(const Case& c)
+{
+  Controller        controller(law(c));
+  std::vector<Real> y(c.n);
+  for (std::size_t k = 0; k < c.n; ++k) {
+    y[k] = controller.step(c.g, k == 0 ? 0 : y[k - 1]);
+  }
+  return y;
+}
+
+// Step response of height g, clipped to [minv, maxv] afterwards like the sympy generator does.
+inline std::vector<Real>
+simulate(const Case& c)
+{
+  if (c.velocity) {
+    return simulate_velocity(c);
+  }
+
+  const auto [num, den] = closed_loop(c);
+
+  std::vector<Real> y(c.n);
+  for (std::size_t k = 0; k < c.n; ++k) {
+    Real acc = 0;
+    for (std::size_t j = 0; j < num.size() && j <= k; ++j) {
+      acc += num[j] * c.g;
+    }
+    for (std::size_t j = 1; j < den.size() && j <= k; ++j) {
+      acc -= den[j] * y[k - j];
+    }
+    y[k] = acc / den[0];
+  }
+  for (auto& v : y) {
+    v = std::clamp<Real>(v, c.minv, c.maxv);
+  }
+  return y;
+}
+
+// Random cases whose discrete gains kp, ki * sp and kd / sp are of order one, so most of the loops
+// are stable over long horizons.
+inline std::vector<Case>
+random_cases(std::size_t count, std::size_t n, std::uint64_t seed)
+{
+  std::mt19937_64                        rng(seed);
+  std::uniform_real_distribution<double> kp(0.0, 0.6);
+  std::uniform_real_distribution<double> ki_sp(0.0, 0.1);
+  std::uniform_real_distribution<double> kd_sp(0.0, 0.3);
+  std::uniform_real_distribution<double> log_sp(std::log(1e-3), std::log(1e-1));
+  std::uniform_real_distribution<double> g(-10.0, 10.0);
+  std::uniform_int_distribution<int>     arch(0, 2);
+
+  std::vector<Case> cases(count);
+  for (auto& c : cases) {
+    c.arch = architectures[arch(rng)];
+    c.sp   = std::exp(log_sp(rng));
+    c.kp   = kp(rng);
+    c.ki   = ki_sp(rng) / c.sp;
+    c.kd   = kd_sp(rng) * c.sp;
+    c.g    = g(rng);
+    c.n    = n;
+  }
+  return cases;
+}
+
+// Calls f(i) for every i in [0, count) on the given number of threads.
+template<typename F>
+void
+parallel_for(std::size_t count, unsigned threads, F&& f)
+{
+  threads = std::max(1u, threads);
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; ++t) {
+    pool.emplace_back([&, t] {
+      for (std::size_t i = t; i < count; i += threads) {
+        f(i);
+      }
+    });
+  }
+  for (auto& thread : pool) {
+    thread.join();
+  }
+}
+
+} // namespace refsim
+
+#endif // MAMEPID_TOOLS_REFSIM_HPP_